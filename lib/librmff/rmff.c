@@ -805,7 +805,8 @@ rmff_read_next_frame(rmff_file_t *file,
                      void *buffer) {
   rmff_frame_t *frame;
   rmff_file_internal_t *fint;
-  uint16_t object_version, length;
+  unsigned char header[12];
+  uint16_t length;
   uint32_t object_id;
   mb_file_io_t *io;
   void *fh;
@@ -823,17 +824,24 @@ rmff_read_next_frame(rmff_file_t *file,
     return NULL;
   }
 
-  object_version = read_uint16_be();
-  length = read_uint16_be();
-  object_id = ((uint32_t)object_version) << 16 | length;
+  /* Both the packet header and the remainder of a following DATA header
+     are twelve bytes long. Read them with a single call instead of
+     field by field. */
+  if (io->read(fh, header, 12) != 12) {
+    set_error(RMFF_ERR_EOF, NULL);
+    return NULL;
+  }
+
+  object_id = rmff_get_uint32_be(&header[0]);
+  length = rmff_get_uint16_be(&header[2]);
   if (object_id == rmffFOURCC('D', 'A', 'T', 'A')) {
-    file->num_packets_in_chunk = read_uint32_be();
-    fint->next_data_offset = read_uint32_be();
+    file->num_packets_in_chunk = rmff_get_uint32_be(&header[4]);
+    fint->next_data_offset = rmff_get_uint32_be(&header[8]);
     file->num_packets_read = 0;
     return rmff_read_next_frame(file, buffer);
   }
   if ((file->num_packets_read >= file->num_packets_in_chunk) ||
-      (object_id == rmffFOURCC('I', 'N', 'D', 'X'))) {
+      (object_id == rmffFOURCC('I', 'N', 'D', 'X')) || (length < 12)) {
     set_error(RMFF_ERR_EOF, NULL);
     return NULL;
   }
@@ -845,10 +853,10 @@ rmff_read_next_frame(rmff_file_t *file,
   }
   frame->data = (unsigned char *)buffer;
   frame->size = length - 12;
-  frame->id = read_uint16_be();
-  frame->timecode = read_uint32_be();
-  frame->reserved = read_uint8();
-  frame->flags = read_uint8();
+  frame->id = rmff_get_uint16_be(&header[4]);
+  frame->timecode = rmff_get_uint32_be(&header[6]);
+  frame->reserved = header[10];
+  frame->flags = header[11];
   if (io->read(fh, frame->data, frame->size) != frame->size) {
     rmff_release_frame(frame);
     set_error(RMFF_ERR_EOF, NULL);
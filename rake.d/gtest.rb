@@ -1,6 +1,6 @@
 #!/usr/bin/env ruby
 
-$gtest_apps     = %w{common propedit}
+$gtest_apps     = %w{common merge mpegparser propedit}
 $gtest_internal = c(:GTEST_TYPE) == "internal"
 
 namespace :tests do
@@ -23,8 +23,10 @@ $build_system_modules[:gtest] = {
 
   :define_tasks => lambda do
     gtest_libs = {
-      'common'   => [],
-      'propedit' => [ :mtxpropedit ],
+      'common'     => [],
+      'merge'      => [ :mtxmerge, :mtxinput, :mtxoutput, :avi, :rmff, :mpegparser, :flac, :vorbis, :ogg ],
+      'mpegparser' => [ :mpegparser ],
+      'propedit'   => [ :mtxpropedit ],
     }
 
     #
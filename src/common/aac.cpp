@@ -335,8 +335,14 @@ find_aac_header(const unsigned char *buf,
                 aac_header_c *aac_header,
                 bool emphasis_present) {
   try {
+    // ADTS headers start with a 0xff byte; skip to those with memchr().
     int bpos = 0;
     while (bpos < size) {
+      auto sync = static_cast<const unsigned char *>(memchr(buf + bpos, 0xff, size - bpos));
+      if (!sync)
+        break;
+
+      bpos = sync - buf;
       if (is_adts_header(buf + bpos, size - bpos, aac_header, emphasis_present))
         return bpos;
       bpos++;
@@ -352,9 +352,22 @@ ac3::parser_c::find_consecutive_frames(unsigned char const *buffer,
 
     size_t position = base;
 
+    // Only positions starting with the first byte of the sync word can
+    // hold a valid header; skip to those with memchr().
     ac3::frame_c first_frame;
-    while (((position + 8) < buffer_size) && !first_frame.decode_header(&buffer[position], buffer_size - position))
+    while ((position + 8) < buffer_size) {
+      auto sync = static_cast<unsigned char const *>(std::memchr(&buffer[position], AC3_SYNC_WORD >> 8, buffer_size - 8 - position));
+      if (!sync) {
+        position = buffer_size - 8;
+        break;
+      }
+
+      position = sync - buffer;
+      if (first_frame.decode_header(&buffer[position], buffer_size - position))
+        break;
+
       ++position;
+    }
 
     mxdebug_if(s_debug, boost::format("First frame at %1% valid %2%\n") % position % first_frame.m_valid);
 
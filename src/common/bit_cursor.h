@@ -27,17 +27,22 @@ private:
   unsigned int m_bits_valid;
   bool m_out_of_data;
 
+protected:
+  bool m_skip_emulation_prevention_bytes{};
+  unsigned int m_num_skipped_bytes{};
+
 public:
   bit_reader_c(const unsigned char *data, unsigned int len) {
     init(data, len);
   }
 
   void init(const unsigned char *data, unsigned int len) {
-    m_end_of_data   = data + len;
-    m_byte_position = data;
-    m_start_of_data = data;
-    m_bits_valid    = len ? 8 : 0;
-    m_out_of_data   = m_byte_position >= m_end_of_data;
+    m_end_of_data       = data + len;
+    m_byte_position     = data;
+    m_start_of_data     = data;
+    m_bits_valid        = len ? 8 : 0;
+    m_out_of_data       = m_byte_position >= m_end_of_data;
+    m_num_skipped_bytes = 0;
   }
 
   bool eof() {
@@ -65,10 +70,8 @@ public:
       r  |= ((*m_byte_position) >> rshift) & (0xff >> (8 - b));
 
       m_bits_valid -= b;
-      if (0 == m_bits_valid) {
-        m_bits_valid     = 8;
-        m_byte_position += 1;
-      }
+      if (0 == m_bits_valid)
+        next_byte();
 
       n -= b;
     }
@@ -97,35 +100,27 @@ public:
   }
 
   uint64_t peek_bits(unsigned int n) {
-    uint64_t r                             = 0;
-    const unsigned char *tmp_byte_position = m_byte_position;
-    unsigned int tmp_bits_valid            = m_bits_valid;
-
-    while (0 < n) {
-      if (tmp_byte_position >= m_end_of_data)
-        throw mtx::mm_io::end_of_file_x();
-
-      unsigned int b = 8; // number of bits to extract from the current byte
-      if (b > n)
-        b = n;
-      if (b > tmp_bits_valid)
-        b = tmp_bits_valid;
-
-      unsigned int rshift = tmp_bits_valid - b;
-
-      r <<= b;
-      r  |= ((*tmp_byte_position) >> rshift) & (0xff >> (8 - b));
-
-      tmp_bits_valid -= b;
-      if (0 == tmp_bits_valid) {
-        tmp_bits_valid     = 8;
-        tmp_byte_position += 1;
-      }
-
-      n -= b;
+    auto byte_position     = m_byte_position;
+    auto bits_valid        = m_bits_valid;
+    auto out_of_data       = m_out_of_data;
+    auto num_skipped_bytes = m_num_skipped_bytes;
+
+    auto restore = [&]() {
+      m_byte_position     = byte_position;
+      m_bits_valid        = bits_valid;
+      m_out_of_data       = out_of_data;
+      m_num_skipped_bytes = num_skipped_bytes;
+    };
+
+    try {
+      auto r = get_bits(n);
+      restore();
+      return r;
+
+    } catch (...) {
+      restore();
+      throw;
     }
-
-    return r;
   }
 
   void get_bytes(unsigned char *buf, size_t n) {
@@ -147,14 +142,21 @@ public:
       throw mtx::mm_io::end_of_file_x();
     }
 
+    if (m_skip_emulation_prevention_bytes) {
+      set_unescaped_bit_position(pos);
+      return;
+    }
+
     m_byte_position = m_start_of_data + (pos / 8);
     m_bits_valid    = 8 - (pos % 8);
   }
 
   int get_bit_position() const {
-    return (m_byte_position - m_start_of_data) * 8 + 8 - m_bits_valid;
+    return (m_byte_position - m_start_of_data - m_num_skipped_bytes) * 8 + 8 - m_bits_valid;
   }
 
+  // Emulation prevention bytes that haven't been reached yet are
+  // counted as well.
   int get_remaining_bits() const {
     return (m_end_of_data - m_byte_position) * 8 - 8 + m_bits_valid;
   }
@@ -166,9 +168,60 @@ public:
   void skip_bit() {
     set_bit_position(get_bit_position() + 1);
   }
+
+private:
+  void next_byte() {
+    m_bits_valid     = 8;
+    m_byte_position += 1;
+
+    if (   m_skip_emulation_prevention_bytes
+        && (m_byte_position < m_end_of_data)
+        && (0x03 == m_byte_position[0])
+        && ((m_byte_position - m_start_of_data) >= 2)
+        && !m_byte_position[-1]
+        && !m_byte_position[-2]) {
+      m_byte_position     += 1;
+      m_num_skipped_bytes += 1;
+    }
+  }
+
+  void set_unescaped_bit_position(unsigned int pos) {
+    auto current = static_cast<unsigned int>(get_bit_position());
+    if (pos < current) {
+      m_byte_position     = m_start_of_data;
+      m_bits_valid        = 8;
+      m_out_of_data       = false;
+      m_num_skipped_bytes = 0;
+      current             = 0;
+    }
+
+    for (auto to_skip = pos - current; 0 < to_skip; to_skip -= std::min(to_skip, 32u))
+      get_bits(std::min(to_skip, 32u));
+
+    if (m_byte_position >= m_end_of_data) {
+      m_out_of_data = true;
+      throw mtx::mm_io::end_of_file_x();
+    }
+  }
 };
 typedef std::shared_ptr<bit_reader_c> bit_reader_cptr;
 
+/** \brief Bit reader for AVC/HEVC NAL units
+
+   Reads the RBSP contained in a NALU by skipping emulation prevention
+   bytes (the 0x03 in 0x00 0x00 0x03) on the fly. Nothing is copied,
+   and only as many bytes are looked at as bits are actually read.
+   Bit positions refer to the RBSP, not to the NALU.
+*/
+class nalu_bit_reader_c: public bit_reader_c {
+public:
+  nalu_bit_reader_c(const unsigned char *data, unsigned int len)
+    : bit_reader_c{data, len}
+  {
+    m_skip_emulation_prevention_bytes = true;
+  }
+};
+
 class bit_writer_c {
 private:
   unsigned char *m_end_of_data;
@@ -84,18 +84,19 @@ find_dts_sync_word(const unsigned char *buf,
     // not enough data for one header
     return -1;
 
-  unsigned int offset = 0;
-  uint32_t sync_word  = get_uint32_be(buf);
-  while ((DTS_HEADER_MAGIC != sync_word) && ((offset + 4) < size)) {
-    sync_word = (sync_word << 8) | buf[offset + 4];
-    ++offset;
+  // Let memchr() find candidates for the sync word's first byte and
+  // only compare the whole word there.
+  auto end = buf + size - 3;
+  auto pos = buf;
+
+  while ((pos = static_cast<const unsigned char *>(memchr(pos, DTS_HEADER_MAGIC >> 24, end - pos)))) {
+    if (DTS_HEADER_MAGIC == get_uint32_be(pos))
+      return pos - buf;
+    ++pos;
   }
 
-  if (DTS_HEADER_MAGIC != sync_word)
-    // no header found
-    return -1;
-
-  return offset;
+  // no header found
+  return -1;
 }
 
 int
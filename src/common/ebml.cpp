@@ -22,6 +22,10 @@
 #include <windows.h>
 #endif
 
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
 #include <ebml/EbmlFloat.h>
 #include <ebml/EbmlSInteger.h>
 #include <ebml/EbmlString.h>
@@ -252,122 +256,150 @@ empty_ebml_master(EbmlElement *e) {
 EbmlElement *
 create_ebml_element(const EbmlCallbacks &callbacks,
                     const EbmlId &id) {
-  const EbmlSemanticContext &context = EBML_INFO_CONTEXT(callbacks);
-  size_t i;
-
-//   if (id == EbmlId(*parent))
-//     return empty_ebml_master(&parent->Generic().Create());
-
-  for (i = 0; i < EBML_CTX_SIZE(context); i++)
-    if (id == EBML_CTX_IDX_ID(context,i))
-      return empty_ebml_master(&EBML_SEM_CREATE(EBML_CTX_IDX(context,i)));
-
-  for (i = 0; i < EBML_CTX_SIZE(context); i++) {
-    EbmlElement *e;
+  auto semantic = find_ebml_semantic(callbacks, id);
+  return semantic ? empty_ebml_master(&EBML_SEM_CREATE(*semantic)) : nullptr;
+}
 
-    if (!(context != EBML_SEM_CONTEXT(EBML_CTX_IDX(context,i))))
-      continue;
+/*
+   Lookup tables for the find_ebml_*() functions
+
+   Looking up an element by ID or by name used to search through the
+   semantic contexts recursively on each call. Now all lookups for a
+   given base element use hash tables which are built on first use. The
+   tree is walked in the same order the recursive search used, and only
+   the first entry found for each key is kept. Therefore the results are
+   identical to those of the recursive search.
+*/
 
-    e = create_ebml_element(EBML_CTX_IDX_INFO(context, i), id);
-    if (e)
-      return e;
-  }
+struct ebml_lookup_tables_t {
+  std::unordered_map<uint64_t, const EbmlCallbacks *> m_callbacks_by_id, m_parent_callbacks_by_id;
+  std::unordered_map<std::string, const EbmlCallbacks *> m_callbacks_by_name;
+  std::unordered_map<uint64_t, const EbmlSemantic *> m_semantics_by_id;
+};
 
-  return nullptr;
+static uint64_t
+ebml_lookup_key(const EbmlId &id) {
+  return (static_cast<uint64_t>(EBML_ID_VALUE(id)) << 8) | EBML_ID_LENGTH(id);
 }
 
-const EbmlCallbacks *
-find_ebml_callbacks(const EbmlCallbacks &base,
-                    const EbmlId &id) {
+static void
+add_to_ebml_lookup_tables(ebml_lookup_tables_t &tables,
+                          const EbmlCallbacks &base) {
   const EbmlSemanticContext &context = EBML_INFO_CONTEXT(base);
-  const EbmlCallbacks *result;
   size_t i;
 
-  if (EBML_INFO_ID(base) == id)
-    return &base;
+  for (i = 0; i < EBML_CTX_SIZE(context); i++) {
+    const EbmlCallbacks &callbacks = EBML_CTX_IDX_INFO(context, i);
+    auto key                       = ebml_lookup_key(EBML_CTX_IDX_ID(context, i));
 
-  for (i = 0; i < EBML_CTX_SIZE(context); i++)
-    if (id == EBML_CTX_IDX_ID(context,i))
-      return &EBML_CTX_IDX_INFO(context, i);
+    tables.m_callbacks_by_id.insert(std::make_pair(key, &callbacks));
+    tables.m_callbacks_by_name.insert(std::make_pair(std::string{EBML_INFO_NAME(callbacks)}, &callbacks));
+    tables.m_parent_callbacks_by_id.insert(std::make_pair(key, &base));
+    tables.m_semantics_by_id.insert(std::make_pair(key, &EBML_CTX_IDX(context, i)));
+  }
 
   for (i = 0; i < EBML_CTX_SIZE(context); i++) {
     if (!(context != EBML_SEM_CONTEXT(EBML_CTX_IDX(context,i))))
       continue;
-    result = find_ebml_callbacks(EBML_CTX_IDX_INFO(context, i), id);
-    if (result)
-      return result;
+    add_to_ebml_lookup_tables(tables, EBML_CTX_IDX_INFO(context, i));
   }
-
-  return nullptr;
 }
 
-const EbmlCallbacks *
-find_ebml_callbacks(const EbmlCallbacks &base,
-                    const char *debug_name) {
-  const EbmlSemanticContext &context = EBML_INFO_CONTEXT(base);
-  const EbmlCallbacks *result;
-  size_t i;
+static std::unique_ptr<ebml_lookup_tables_t>
+create_ebml_lookup_tables(const EbmlCallbacks &base) {
+  auto tables = std::unique_ptr<ebml_lookup_tables_t>{new ebml_lookup_tables_t};
 
-  if (!strcmp(debug_name, EBML_INFO_NAME(base)))
-    return &base;
+  tables->m_callbacks_by_id.insert(std::make_pair(ebml_lookup_key(EBML_INFO_ID(base)), &base));
+  tables->m_callbacks_by_name.insert(std::make_pair(std::string{EBML_INFO_NAME(base)}, &base));
+  add_to_ebml_lookup_tables(*tables, base);
 
-  for (i = 0; i < EBML_CTX_SIZE(context); i++)
-    if (!strcmp(debug_name, EBML_INFO_NAME(EBML_CTX_IDX_INFO(context, i))))
-      return &EBML_CTX_IDX_INFO(context, i);
+  return tables;
+}
 
-  for (i = 0; i < EBML_CTX_SIZE(context); i++) {
-    if (!(context != EBML_SEM_CONTEXT(EBML_CTX_IDX(context,i))))
-      continue;
-    result = find_ebml_callbacks(EBML_CTX_IDX_INFO(context, i), debug_name);
-    if (result)
-      return result;
+/* The tables for each base element are built exactly once and never
+   modified afterwards. They're published in a small array whose filled
+   part is announced by an atomic counter, so that looking up the
+   tables for a known base doesn't take a lock. Only building new
+   tables is serialized by the mutex. In practice there are only a
+   handful of different base elements; should that ever be exceeded,
+   the remaining ones are kept in a map that is accessed with the mutex
+   held. */
+
+struct ebml_lookup_slot_t {
+  const EbmlCallbacks *m_base;
+  std::unique_ptr<ebml_lookup_tables_t> m_tables;
+};
+
+static const ebml_lookup_tables_t &
+get_ebml_lookup_tables(const EbmlCallbacks &base) {
+  static ebml_lookup_slot_t s_slots[16];
+  static std::atomic<size_t> s_num_slots{0};
+  static std::mutex s_mutex;
+  static std::unordered_map<const EbmlCallbacks *, std::unique_ptr<ebml_lookup_tables_t> > s_other_tables;
+
+  auto num_slots = s_num_slots.load(std::memory_order_acquire);
+  for (auto idx = 0u; idx < num_slots; ++idx)
+    if (s_slots[idx].m_base == &base)
+      return *s_slots[idx].m_tables;
+
+  std::lock_guard<std::mutex> lock(s_mutex);
+
+  num_slots = s_num_slots.load(std::memory_order_relaxed);
+  for (auto idx = 0u; idx < num_slots; ++idx)
+    if (s_slots[idx].m_base == &base)
+      return *s_slots[idx].m_tables;
+
+  auto other_itr = s_other_tables.find(&base);
+  if (s_other_tables.end() != other_itr)
+    return *other_itr->second;
+
+  auto tables = create_ebml_lookup_tables(base);
+
+  if (num_slots == (sizeof(s_slots) / sizeof(s_slots[0]))) {
+    auto &other_tables = s_other_tables[&base];
+    other_tables       = std::move(tables);
+    return *other_tables;
   }
 
-  return nullptr;
+  auto &slot    = s_slots[num_slots];
+  slot.m_base   = &base;
+  slot.m_tables = std::move(tables);
+
+  s_num_slots.store(num_slots + 1, std::memory_order_release);
+
+  return *slot.m_tables;
 }
 
-const EbmlCallbacks *
-find_ebml_parent_callbacks(const EbmlCallbacks &base,
-                           const EbmlId &id) {
-  const EbmlSemanticContext &context = EBML_INFO_CONTEXT(base);
-  const EbmlCallbacks *result;
-  size_t i;
+template<typename Tkey, typename Tvalue>
+static const Tvalue *
+find_in_ebml_lookup_table(const std::unordered_map<Tkey, const Tvalue *> &table,
+                          const Tkey &key) {
+  auto itr = table.find(key);
+  return table.end() == itr ? nullptr : itr->second;
+}
 
-  for (i = 0; i < EBML_CTX_SIZE(context); i++)
-    if (id == EBML_CTX_IDX_ID(context,i))
-      return &base;
+const EbmlCallbacks *
+find_ebml_callbacks(const EbmlCallbacks &base,
+                    const EbmlId &id) {
+  return find_in_ebml_lookup_table(get_ebml_lookup_tables(base).m_callbacks_by_id, ebml_lookup_key(id));
+}
 
-  for (i = 0; i < EBML_CTX_SIZE(context); i++) {
-    if (!(context != EBML_SEM_CONTEXT(EBML_CTX_IDX(context,i))))
-      continue;
-    result = find_ebml_parent_callbacks(EBML_CTX_IDX_INFO(context, i), id);
-    if (result)
-      return result;
-  }
+const EbmlCallbacks *
+find_ebml_callbacks(const EbmlCallbacks &base,
+                    const char *debug_name) {
+  return find_in_ebml_lookup_table(get_ebml_lookup_tables(base).m_callbacks_by_name, std::string{debug_name});
+}
 
-  return nullptr;
+const EbmlCallbacks *
+find_ebml_parent_callbacks(const EbmlCallbacks &base,
+                           const EbmlId &id) {
+  return find_in_ebml_lookup_table(get_ebml_lookup_tables(base).m_parent_callbacks_by_id, ebml_lookup_key(id));
 }
 
 const EbmlSemantic *
 find_ebml_semantic(const EbmlCallbacks &base,
                    const EbmlId &id) {
-  const EbmlSemanticContext &context = EBML_INFO_CONTEXT(base);
-  const EbmlSemantic *result;
-  size_t i;
-
-  for (i = 0; i < EBML_CTX_SIZE(context); i++)
-    if (id == EBML_CTX_IDX_ID(context,i))
-      return &EBML_CTX_IDX(context,i);
-
-  for (i = 0; i < EBML_CTX_SIZE(context); i++) {
-    if (!(context != EBML_SEM_CONTEXT(EBML_CTX_IDX(context,i))))
-      continue;
-    result = find_ebml_semantic(EBML_CTX_IDX_INFO(context, i), id);
-    if (result)
-      return result;
-  }
-
-  return nullptr;
+  return find_in_ebml_lookup_table(get_ebml_lookup_tables(base).m_semantics_by_id, ebml_lookup_key(id));
 }
 
 EbmlMaster *
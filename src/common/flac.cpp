@@ -22,6 +22,7 @@
 #include <FLAC/stream_decoder.h>
 
 #include "common/bit_cursor.h"
+#include "common/checksums.h"
 #include "common/flac.h"
 
 static bool
@@ -127,6 +128,152 @@ flac_get_num_samples(unsigned char *mem,
   }
 }
 
+/** \brief Validate a frame header
+
+   Checks the sync code, the reserved values and the header's CRC-8.
+
+   \return The frame header's size including its CRC-8 if it is valid
+     and \c 0 otherwise, e.g. if \c size is too small for the whole
+     header.
+*/
+size_t
+flac_get_frame_header_size(unsigned char const *buf,
+                           size_t size) {
+  if ((6 > size) || (0xff != buf[0]) || (0xf8 != (buf[1] & 0xfe)))
+    return 0;
+
+  auto block_size_code  = buf[2] >> 4;
+  auto sample_rate_code = buf[2] & 0x0f;
+  auto channel_code     = buf[3] >> 4;
+  auto sample_size_code = (buf[3] >> 1) & 0x07;
+
+  if (   (0x00 == block_size_code)
+      || (0x0f == sample_rate_code)
+      || (0x0a <  channel_code)
+      || (0x03 == sample_size_code)
+      || (0x07 == sample_size_code)
+      || (buf[3] & 0x01))
+    return 0;
+
+  // UTF-8 coded frame or sample number
+  size_t num_bytes;
+  if (!(buf[4] & 0x80))
+    num_bytes = 1;
+  else if (0xc0 == (buf[4] & 0xe0))
+    num_bytes = 2;
+  else if (0xe0 == (buf[4] & 0xf0))
+    num_bytes = 3;
+  else if (0xf0 == (buf[4] & 0xf8))
+    num_bytes = 4;
+  else if (0xf8 == (buf[4] & 0xfc))
+    num_bytes = 5;
+  else if (0xfc == (buf[4] & 0xfe))
+    num_bytes = 6;
+  else if (0xfe == buf[4])
+    num_bytes = 7;
+  else
+    return 0;
+
+  size_t pos = 4 + num_bytes;
+  if (pos > size)
+    return 0;
+
+  for (size_t idx = 5; idx < pos; ++idx)
+    if (0x80 != (buf[idx] & 0xc0))
+      return 0;
+
+  pos += 6 == block_size_code  ? 1
+       : 7 == block_size_code  ? 2
+       :                         0;
+  pos += 12 == sample_rate_code ? 1
+       : 13 <= sample_rate_code ? 2
+       :                          0;
+
+  // The CRC-8 covers the whole header including the CRC itself.
+  if ((pos + 1) > size)
+    return 0;
+
+  return crc_calc(crc_get_table(CRC_8_ATM), 0, buf, pos + 1) ? 0 : pos + 1;
+}
+
+/** \brief Verify a complete frame's CRC-16 stored in its last two bytes
+*/
+bool
+flac_frame_crc_ok(unsigned char const *buf,
+                  size_t size) {
+  return !crc_calc(crc_get_table(CRC_16_ANSI), 0, buf, size);
+}
+
+/** \brief Determine the size of the frame at the start of a buffer
+
+   A frame ends where the next valid frame header starts. The sync code
+   may also occur inside a frame's data, though. Therefore the frame's
+   CRC-16 must match as well. The CRC is updated incrementally from one
+   header candidate to the next.
+
+   If a frame is damaged then its CRC never matches. The search is
+   therefore given up once it passes \c max_frame_size bytes, and the
+   frame ends at the first header candidate instead. The same happens if
+   the end of the data is reached without a match. \c crc_mismatch is
+   set in \c search in both cases.
+
+   The last frame ends at the last position at which its CRC-16
+   matches. Anything following it (e.g. an ID3v1 tag) is dropped.
+
+   \return The frame's size or \c 0 if more data is needed. Call again
+     with the same \c search object once more data has been appended
+     to the buffer.
+*/
+size_t
+flac_find_frame_size(unsigned char const *buf,
+                     size_t size,
+                     size_t max_frame_size,
+                     bool end_of_data,
+                     flac_frame_search_t &search) {
+  auto crc_table = crc_get_table(CRC_16_ANSI);
+  auto end       = end_of_data ? size : size - std::min<size_t>(size, FLAC_MAX_FRAME_HEADER_SIZE);
+
+  for (; search.position < end; ++search.position) {
+    auto pos = search.position;
+
+    if (search.first_header && (pos > max_frame_size)) {
+      search.crc_mismatch = true;
+      return search.first_header;
+    }
+
+    if ((0xff != buf[pos]) || !flac_get_frame_header_size(&buf[pos], size - pos))
+      continue;
+
+    if (!search.first_header)
+      search.first_header = pos;
+
+    search.crc     = crc_calc(crc_table, search.crc, &buf[search.crc_end], pos - search.crc_end);
+    search.crc_end = pos;
+
+    if (!search.crc)
+      return pos;
+  }
+
+  if (!end_of_data)
+    return 0;
+
+  size_t last_end = 0;
+  for (auto pos = search.crc_end; pos < size; ++pos) {
+    search.crc = crc_calc(crc_table, search.crc, &buf[pos], 1);
+    if (!search.crc)
+      last_end = pos + 1;
+  }
+
+  if (last_end)
+    return last_end;
+
+  if (!search.first_header)
+    return size;
+
+  search.crc_mismatch = true;
+  return search.first_header;
+}
+
 #define FPFX "flac_decode_headers: "
 
 typedef struct {
@@ -26,7 +26,30 @@
 #define FLAC_HEADER_APPLICATION      8
 #define FLAC_HEADER_SEEKTABLE       16
 
+#define FLAC_MAX_FRAME_HEADER_SIZE  16
+
+// State of the search for the end of the frame at the start of a
+// buffer; kept across calls to flac_find_frame_size() while the
+// buffer grows.
+struct flac_frame_search_t {
+  size_t position, first_header, crc_end;
+  uint32_t crc;
+  bool crc_mismatch;
+
+  flac_frame_search_t()
+    : position{1}
+    , first_header{}
+    , crc_end{}
+    , crc{}
+    , crc_mismatch{}
+  {
+  }
+};
+
 int flac_get_num_samples(unsigned char *buf, int size, FLAC__StreamMetadata_StreamInfo &stream_info);
+size_t flac_get_frame_header_size(unsigned char const *buf, size_t size);
+bool flac_frame_crc_ok(unsigned char const *buf, size_t size);
+size_t flac_find_frame_size(unsigned char const *buf, size_t size, size_t max_frame_size, bool end_of_data, flac_frame_search_t &search);
 int flac_decode_headers(unsigned char *mem, int size, int num_elements, ...);
 
 #endif /* HAVE_FLAC_FORMAT_H */
@@ -134,6 +134,10 @@ public:
 
   virtual bool process(parse_mode_e parse_mode = parse_mode_full, const open_mode mode = MODE_WRITE, bool throw_on_error = false);
 
+  std::string const &get_file_name() const {
+    return m_file_name;
+  }
+
   virtual void show_progress_start(int64_t /* size */) {
   }
   virtual bool show_progress_running(int /* percentage */) {
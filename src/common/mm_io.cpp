@@ -24,6 +24,10 @@
 #endif
 #include <sys/stat.h>
 #include <sys/types.h>
+#if !defined(SYS_WINDOWS)
+#include <limits.h>
+#include <sys/uio.h>
+#endif
 
 #include "common/endian.h"
 #include "common/error.h"
@@ -108,6 +112,64 @@ mm_file_io_c::_write(const void *buffer,
   return bwritten;
 }
 
+size_t
+mm_file_io_c::_write_gathered(buffer_list_t const &buffers) {
+  // Data still in stdio's buffer must hit the file before writev()
+  // writes to the descriptor directly.
+  if (fflush((FILE *)m_file) != 0)
+    throw mtx::mm_io::read_write_x{mtx::mm_io::make_error_code()};
+
+  std::vector<iovec> iov;
+  for (auto const &buffer : buffers)
+    if (buffer.second)
+      iov.push_back(iovec{const_cast<void *>(buffer.first), buffer.second});
+
+  auto fd      = fileno((FILE *)m_file);
+  size_t idx   = 0;
+  size_t total = 0;
+
+  // After reads stdio may have read ahead, leaving the descriptor's
+  // offset beyond the logical position. Not all C libraries move it
+  // back in fflush(), so position the descriptor explicitly.
+  if (lseek(fd, m_current_position, SEEK_SET) == static_cast<off_t>(-1))
+    throw mtx::mm_io::seek_x{mtx::mm_io::make_error_code()};
+
+  while (idx < iov.size()) {
+    auto num_iov  = static_cast<int>(std::min<size_t>(iov.size() - idx, IOV_MAX));
+    auto bwritten = writev(fd, &iov[idx], num_iov);
+
+    if ((0 > bwritten) && (EINTR == errno))
+      continue;
+    if (0 > bwritten)
+      throw mtx::mm_io::read_write_x{mtx::mm_io::make_error_code()};
+    if (0 == bwritten)
+      break;
+
+    total += bwritten;
+
+    // Skip over fully written entries and adjust a partially written one.
+    auto left = static_cast<size_t>(bwritten);
+    while ((idx < iov.size()) && (left >= iov[idx].iov_len)) {
+      left -= iov[idx].iov_len;
+      ++idx;
+    }
+
+    if (left) {
+      iov[idx].iov_base  = static_cast<char *>(iov[idx].iov_base) + left;
+      iov[idx].iov_len  -= left;
+    }
+  }
+
+  m_current_position += total;
+  m_cached_size       = -1;
+
+  // Let stdio pick up the descriptor's new position.
+  if (fseeko((FILE *)m_file, m_current_position, SEEK_SET) != 0)
+    throw mtx::mm_io::seek_x{mtx::mm_io::make_error_code()};
+
+  return total;
+}
+
 uint32
 mm_file_io_c::_read(void *buffer,
                     size_t size) {
@@ -506,6 +568,26 @@ mm_io_c::write(const void *buffer,
   return _write(buffer, size);
 }
 
+size_t
+mm_io_c::write_gathered(buffer_list_t const &buffers) {
+  return _write_gathered(buffers);
+}
+
+size_t
+mm_io_c::_write_gathered(buffer_list_t const &buffers) {
+  size_t total = 0;
+
+  for (auto const &buffer : buffers) {
+    auto bwritten  = _write(buffer.first, buffer.second);
+    total         += bwritten;
+
+    if (bwritten != buffer.second)
+      break;
+  }
+
+  return total;
+}
+
 size_t
 mm_io_c::write(const memory_cptr &buffer,
                size_t size,
@@ -636,6 +718,11 @@ mm_proxy_io_c::_write(const void *buffer,
   return m_proxy_io->write(buffer, size);
 }
 
+size_t
+mm_proxy_io_c::_write_gathered(buffer_list_t const &buffers) {
+  return m_proxy_io->write_gathered(buffers);
+}
+
 /*
    Dummy class for output to /dev/null. Needed for two pass stuff.
 */
@@ -1067,6 +1154,112 @@ mm_text_io_c::getline() {
   }
 }
 
+// Reads all remaining lines. The result is the same as calling
+// getline() until it fails. For single-byte and UTF-8 content the data
+// is read in one go instead of character by character.
+std::vector<std::string>
+mm_text_io_c::getlines() {
+  std::vector<std::string> lines;
+
+  if (eof())
+    return lines;
+
+  if (!m_eol_style_detected)
+    detect_eol_style();
+
+  if ((BO_NONE != m_byte_order) && (BO_UTF8 != m_byte_order)) {
+    std::string line;
+    while (getline2(line))
+      lines.push_back(line);
+
+    return lines;
+  }
+
+  auto start_pos = getFilePointer();
+  auto content   = memory_c::alloc(get_size() - start_pos);
+  auto size      = read(content->get_buffer(), content->get_size());
+  auto buffer    = content->get_buffer();
+  auto pos       = 0u;
+
+  while (pos < size) {
+    std::string line;
+    auto previous_was_carriage_return = false;
+
+    while (pos < size) {
+      // Copy runs of plain characters in one go.
+      if (!previous_was_carriage_return) {
+        auto run_end = pos;
+        while (   (run_end < size)
+               && ('\r' != buffer[run_end])
+               && ('\n' != buffer[run_end])
+               && buffer[run_end]
+               && ((BO_NONE == m_byte_order) || (0x80 > buffer[run_end])))
+          ++run_end;
+
+        if (run_end != pos) {
+          line.append(reinterpret_cast<char const *>(&buffer[pos]), run_end - pos);
+          pos = run_end;
+          continue;
+        }
+      }
+
+      auto c   = buffer[pos];
+      auto len = 1u;
+
+      if (BO_UTF8 == m_byte_order) {
+        len = ((c & 0x80) == 0x00) ?  1
+            : ((c & 0xe0) == 0xc0) ?  2
+            : ((c & 0xf0) == 0xe0) ?  3
+            : ((c & 0xf8) == 0xf0) ?  4
+            : ((c & 0xfc) == 0xf8) ?  5
+            : ((c & 0xfe) == 0xfc) ?  6
+            :                        99;
+
+        // getline() would throw here, and the partial line is lost.
+        if (99 == len) {
+          mm_proxy_io_c::setFilePointer(start_pos + pos + 1, seek_beginning);
+          return lines;
+        }
+
+        if ((pos + len) > size) {
+          pos = size;
+          break;
+        }
+      }
+
+      if ((1 == len) && ('\r' == c)) {
+        if (previous_was_carriage_return && !m_uses_newlines)
+          break;
+
+        previous_was_carriage_return = true;
+        ++pos;
+        continue;
+      }
+
+      if ((1 == len) && ('\n' == c) && (!m_uses_carriage_returns || previous_was_carriage_return)) {
+        ++pos;
+        break;
+      }
+
+      if (previous_was_carriage_return)
+        break;
+
+      // getline() appends characters as C strings, dropping anything
+      // from a NUL byte onwards.
+      auto end = pos + len;
+      while ((pos < end) && buffer[pos])
+        line += static_cast<char>(buffer[pos++]);
+      pos = end;
+    }
+
+    lines.push_back(line);
+  }
+
+  mm_proxy_io_c::setFilePointer(start_pos + pos, seek_beginning);
+
+  return lines;
+}
+
 void
 mm_text_io_c::setFilePointer(int64 offset,
                              seek_mode mode) {
@@ -29,6 +29,9 @@ class charset_converter_c;
 typedef std::shared_ptr<charset_converter_c> charset_converter_cptr;
 
 class mm_io_c: public IOCallback {
+public:
+  typedef std::vector<std::pair<const void *, size_t> > buffer_list_t;
+
 protected:
   bool m_dos_style_newlines, m_bom_written;
   std::stack<int64_t> m_positions;
@@ -76,6 +79,7 @@ public:
   virtual size_t write(const void *buffer, size_t size);
   virtual size_t write(std::string const &buffer);
   virtual size_t write(const memory_cptr &buffer, size_t size = UINT_MAX, size_t offset = 0);
+  virtual size_t write_gathered(buffer_list_t const &buffers);
   virtual bool eof() = 0;
   virtual void flush() {
   }
@@ -116,6 +120,7 @@ public:
 protected:
   virtual uint32 _read(void *buffer, size_t size) = 0;
   virtual size_t _write(const void *buffer, size_t size) = 0;
+  virtual size_t _write_gathered(buffer_list_t const &buffers);
 };
 
 class mm_file_io_c: public mm_io_c {
@@ -155,6 +160,9 @@ public:
 protected:
   virtual uint32 _read(void *buffer, size_t size);
   virtual size_t _write(const void *buffer, size_t size);
+#if !defined(SYS_WINDOWS)
+  virtual size_t _write_gathered(buffer_list_t const &buffers);
+#endif
 };
 
 typedef std::shared_ptr<mm_file_io_c> mm_file_io_cptr;
@@ -194,6 +202,7 @@ public:
 protected:
   virtual uint32 _read(void *buffer, size_t size);
   virtual size_t _write(const void *buffer, size_t size);
+  virtual size_t _write_gathered(buffer_list_t const &buffers);
 };
 
 typedef std::shared_ptr<mm_proxy_io_c> mm_proxy_io_cptr;
@@ -268,6 +277,7 @@ public:
 
   virtual void setFilePointer(int64 offset, seek_mode mode=seek_beginning);
   virtual std::string getline();
+  virtual std::vector<std::string> getlines();
   virtual int read_next_char(char *buffer);
   virtual byte_order_e get_byte_order() const {
     return m_byte_order;
@@ -15,12 +15,19 @@
 
 #include <sstream>
 
+#include "common/hacks.h"
 #include "common/mm_io_x.h"
 #include "common/mm_multi_file_io.h"
 #include "common/output.h"
 #include "common/strings/editing.h"
 #include "common/strings/parsing.h"
 
+namespace {
+uint64_t const s_prefetch_threshold  =  4 * 1024 * 1024;
+uint64_t const s_prefetch_size       = 32 * 1024 * 1024;
+uint64_t const s_prefetch_chunk_size =      1024 * 1024;
+}
+
 mm_multi_file_io_c::file_t::file_t(const bfs::path &file_name,
                                    uint64_t global_start,
                                    mm_file_io_cptr file)
@@ -38,6 +45,11 @@ mm_multi_file_io_c::mm_multi_file_io_c(const std::vector<bfs::path> &file_names,
   , m_current_pos(0)
   , m_current_local_pos(0)
   , m_current_file(0)
+  , m_prefetched_bytes(0)
+  , m_prefetch_front_offset(0)
+  , m_sequential_bytes(0)
+  , m_prefetch_stop(false)
+  , m_prefetch_done(false)
 {
   for (auto &file_name : file_names) {
     mm_file_io_cptr file(new mm_file_io_c(file_name.string()));
@@ -67,15 +79,27 @@ mm_multi_file_io_c::setFilePointer(int64 offset,
   if ((0 > new_pos) || (static_cast<int64_t>(m_total_size) < new_pos))
     throw mtx::mm_io::seek_x();
 
+  if (m_prefetch_thread.joinable() && (static_cast<uint64_t>(new_pos) == m_current_pos))
+    return;
+
+  stop_prefetching();
+
+  m_sequential_bytes = 0;
+  m_current_pos      = new_pos;
+
+  seek_to_current_pos();
+}
+
+void
+mm_multi_file_io_c::seek_to_current_pos() {
   m_current_file = 0;
   for (auto &file : m_files) {
-    if ((file.m_global_start + file.m_size) < static_cast<uint64_t>(new_pos)) {
+    if ((file.m_global_start + file.m_size) < m_current_pos) {
       ++m_current_file;
       continue;
     }
 
-    m_current_pos       = new_pos;
-    m_current_local_pos = new_pos - file.m_global_start;
+    m_current_local_pos = m_current_pos - file.m_global_start;
     file.m_file->setFilePointer(m_current_local_pos, seek_beginning);
     break;
   }
@@ -84,17 +108,48 @@ mm_multi_file_io_c::setFilePointer(int64 offset,
 uint32
 mm_multi_file_io_c::_read(void *buffer,
                           size_t size) {
-  size_t num_read_total     = 0;
-  unsigned char *buffer_ptr = static_cast<unsigned char *>(buffer);
+  auto buffer_ptr = static_cast<unsigned char *>(buffer);
+
+  if (   !m_prefetch_thread.joinable()
+      && (m_sequential_bytes >= s_prefetch_threshold)
+      && !eof()
+      && !hack_engaged(ENGAGE_NO_PREFETCHING))
+    start_prefetching();
+
+  if (!m_prefetch_thread.joinable()) {
+    auto num_read       = read_directly(buffer_ptr, size);
+    m_sequential_bytes += num_read;
+
+    return num_read;
+  }
+
+  auto num_read = read_prefetched(buffer_ptr, size);
+  if (num_read == size)
+    return num_read;
+
+  // The prefetching thread has stopped, either at the end of the last
+  // file or due to a read error. Let the caller see whatever reading
+  // directly results in.
+  stop_prefetching();
+  seek_to_current_pos();
+  m_sequential_bytes = 0;
+
+  return num_read + read_directly(buffer_ptr + num_read, size - num_read);
+}
+
+size_t
+mm_multi_file_io_c::read_directly(unsigned char *buffer,
+                                  size_t size) {
+  size_t num_read_total = 0;
 
   while (!eof() && (num_read_total < size)) {
     mm_multi_file_io_c::file_t &file = m_files[m_current_file];
     size_t num_to_read = static_cast<size_t>(std::min(static_cast<uint64_t>(size) - static_cast<uint64_t>(num_read_total), file.m_size - m_current_local_pos));
 
     if (0 != num_to_read) {
-      size_t num_read      = file.m_file->read(buffer_ptr, num_to_read);
+      size_t num_read      = file.m_file->read(buffer, num_to_read);
       num_read_total      += num_read;
-      buffer_ptr          += num_read;
+      buffer              += num_read;
       m_current_local_pos += num_read;
       m_current_pos       += num_read;
 
@@ -112,6 +167,144 @@ mm_multi_file_io_c::_read(void *buffer,
   return num_read_total;
 }
 
+size_t
+mm_multi_file_io_c::read_prefetched(unsigned char *buffer,
+                                    size_t size) {
+  size_t num_read_total = 0;
+
+  {
+    std::unique_lock<std::mutex> lock{m_prefetch_mutex};
+
+    while (num_read_total < size) {
+      m_prefetch_data_available.wait(lock, [this]() { return !m_prefetched.empty() || m_prefetch_done; });
+
+      if (m_prefetched.empty())
+        break;
+
+      auto &chunk      = *m_prefetched.front();
+      auto num_to_copy = std::min<uint64_t>(size - num_read_total, chunk.get_size() - m_prefetch_front_offset);
+
+      std::memcpy(buffer + num_read_total, chunk.get_buffer() + m_prefetch_front_offset, num_to_copy);
+
+      num_read_total          += num_to_copy;
+      m_prefetch_front_offset += num_to_copy;
+
+      if (m_prefetch_front_offset < chunk.get_size())
+        continue;
+
+      m_prefetched_bytes      -= chunk.get_size();
+      m_prefetch_front_offset  = 0;
+      m_prefetched.pop_front();
+
+      m_prefetch_space_available.notify_one();
+    }
+  }
+
+  // Keep the file index and local position up to date as eof() relies
+  // on them.
+  m_current_pos += num_read_total;
+
+  while (((m_current_file + 1) < m_files.size()) && (m_current_pos >= m_files[m_current_file + 1].m_global_start))
+    ++m_current_file;
+
+  m_current_local_pos = m_current_pos - m_files[m_current_file].m_global_start;
+
+  return num_read_total;
+}
+
+void
+mm_multi_file_io_c::start_prefetching() {
+  m_prefetched.clear();
+  m_prefetched_bytes      = 0;
+  m_prefetch_front_offset = 0;
+  m_prefetch_stop         = false;
+  m_prefetch_done         = false;
+  m_prefetch_thread       = std::thread{&mm_multi_file_io_c::prefetch, this, m_current_pos};
+}
+
+void
+mm_multi_file_io_c::stop_prefetching() {
+  if (!m_prefetch_thread.joinable())
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock{m_prefetch_mutex};
+    m_prefetch_stop = true;
+  }
+
+  m_prefetch_space_available.notify_one();
+  m_prefetch_thread.join();
+
+  m_prefetched.clear();
+  m_prefetched_bytes      = 0;
+  m_prefetch_front_offset = 0;
+}
+
+void
+mm_multi_file_io_c::prefetch(uint64_t start_pos) {
+  // Runs on the prefetching thread. m_files is not modified while it
+  // is running; the files are opened a second time so that the
+  // positions of the handles used by the reading thread stay intact.
+  try {
+    auto pos      = start_pos;
+    auto file_idx = 0u;
+    auto in       = mm_file_io_cptr{};
+
+    while (((file_idx + 1) < m_files.size()) && (pos >= m_files[file_idx + 1].m_global_start))
+      ++file_idx;
+
+    while (pos < m_total_size) {
+      {
+        std::unique_lock<std::mutex> lock{m_prefetch_mutex};
+        m_prefetch_space_available.wait(lock, [this]() { return m_prefetch_stop || (m_prefetched_bytes < s_prefetch_size); });
+
+        if (m_prefetch_stop)
+          break;
+      }
+
+      auto &file     = m_files[file_idx];
+      auto local_pos = pos - file.m_global_start;
+
+      if (local_pos >= file.m_size) {
+        ++file_idx;
+        in.reset();
+        continue;
+      }
+
+      if (!in) {
+        in = mm_file_io_cptr(new mm_file_io_c(file.m_file_name.string()));
+        in->setFilePointer(local_pos, seek_beginning);
+      }
+
+      auto chunk    = memory_c::alloc(std::min(s_prefetch_chunk_size, file.m_size - local_pos));
+      auto num_read = in->read(chunk->get_buffer(), chunk->get_size());
+
+      if (!num_read)
+        break;
+
+      chunk->set_size(num_read);
+      pos += num_read;
+
+      {
+        std::lock_guard<std::mutex> lock{m_prefetch_mutex};
+        m_prefetched.push_back(chunk);
+        m_prefetched_bytes += num_read;
+      }
+
+      m_prefetch_data_available.notify_one();
+    }
+
+  } catch (...) {
+  }
+
+  {
+    std::lock_guard<std::mutex> lock{m_prefetch_mutex};
+    m_prefetch_done = true;
+  }
+
+  m_prefetch_data_available.notify_one();
+}
+
 size_t
 mm_multi_file_io_c::_write(const void *,
                            size_t) {
@@ -120,6 +313,8 @@ mm_multi_file_io_c::_write(const void *,
 
 void
 mm_multi_file_io_c::close() {
+  stop_prefetching();
+
   for (auto &file : m_files)
     file.m_file->close();
 
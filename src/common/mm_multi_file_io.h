@@ -16,6 +16,11 @@
 
 #include "common/common_pch.h"
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
 #include "common/mm_io.h"
 
 class mm_multi_file_io_c;
@@ -37,6 +42,16 @@ protected:
   unsigned int m_current_file;
   std::vector<mm_multi_file_io_c::file_t> m_files;
 
+  // Read-ahead on a background thread. It is started once enough data
+  // has been read sequentially and stopped on each seek. The thread
+  // uses its own file handles and may cross file boundaries.
+  std::deque<memory_cptr> m_prefetched;
+  uint64_t m_prefetched_bytes, m_prefetch_front_offset, m_sequential_bytes;
+  bool m_prefetch_stop, m_prefetch_done;
+  std::mutex m_prefetch_mutex;
+  std::condition_variable m_prefetch_data_available, m_prefetch_space_available;
+  std::thread m_prefetch_thread;
+
 public:
   mm_multi_file_io_c(const std::vector<bfs::path> &file_names, const std::string &display_file_name);
   virtual ~mm_multi_file_io_c();
@@ -59,6 +74,14 @@ public:
 protected:
   virtual uint32 _read(void *buffer, size_t size);
   virtual size_t _write(const void *buffer, size_t size);
+
+  size_t read_directly(unsigned char *buffer, size_t size);
+  size_t read_prefetched(unsigned char *buffer, size_t size);
+  void seek_to_current_pos();
+
+  void start_prefetching();
+  void stop_prefetching();
+  void prefetch(uint64_t start_pos);
 };
 
 #endif  // MTX_COMMON_MM_MULTI_FILE_IO_H
@@ -88,30 +88,27 @@ mm_write_buffer_io_c::_read(void *buffer,
 size_t
 mm_write_buffer_io_c::_write(const void *buffer,
                              size_t size) {
-  size_t avail;
   const char *buf = static_cast<const char *>(buffer);
   size_t remain   = size;
 
-  // whole blocks
-  while (remain >= (avail = m_size - m_fill)) {
-    if (m_fill) {
-      // Fill the buffer in an attempt to defeat potentially
-      // lousy OS I/O scheduling
-      memcpy(m_buffer + m_fill, buf, avail);
-      m_fill = m_size;
-      flush_buffer();
-      remain -= avail;
-      buf    += avail;
-
-    } else {
-      // write whole blocks, skipping the buffer
-      avail = mm_proxy_io_c::_write(buf, m_size);
-      if (avail != m_size)
-        throw mtx::mm_io::insufficient_space_x();
-
-      remain -= avail;
-      buf    += avail;
-    }
+  if (remain >= (m_size - m_fill)) {
+    // Write the buffered data and as many whole blocks of the new data
+    // as possible in one go without copying the new data into the
+    // buffer first. The total amount written is still a multiple of
+    // the buffer size in an attempt to defeat potentially lousy OS I/O
+    // scheduling.
+    size_t direct  = ((m_fill + remain) / m_size) * m_size - m_fill;
+    size_t fill    = m_fill;
+    size_t written = mm_proxy_io_c::_write_gathered({ { m_buffer, fill }, { buf, direct } });
+    m_fill         = 0;
+
+    mxdebug_if(m_debug_write, boost::format("gathered write at %1% for %2% + %3% written %4%\n") % (mm_proxy_io_c::getFilePointer() - written) % fill % direct % written);
+
+    if (written != (fill + direct))
+      throw mtx::mm_io::insufficient_space_x();
+
+    remain -= direct;
+    buf    += direct;
   }
 
   if (remain) {
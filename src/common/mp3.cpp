@@ -134,6 +134,11 @@ find_mp3_header(const unsigned char *buf,
     return -1;
 
   for (pos = 0; pos < (size - 4); pos++) {
+    // Only ID3 tags, TAG tags and frame headers starting with 0xff can
+    // match. Skip everything else before assembling the header.
+    if ((buf[pos] != 0xff) && (buf[pos] != 'I') && (buf[pos] != 'T'))
+      continue;
+
     if ((buf[pos] == 'I') && (buf[pos + 1] == 'D') && (buf[pos + 2] == '3')) {
       if ((pos + 10) >= size)
         return -1;
@@ -0,0 +1,233 @@
+/** MPEG helper functions shared by the AVC and HEVC code
+
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   \file
+
+   \author Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include "common/endian.h"
+#include "common/mpeg.h"
+
+namespace mtx { namespace mpeg {
+
+static uint64_t
+get_nalu_size(unsigned char const *buffer,
+              unsigned int size_len) {
+  return 4 == size_len ? get_uint32_be(buffer)
+       : 3 == size_len ? get_uint24_be(buffer)
+       : 2 == size_len ? get_uint16_be(buffer)
+       :                 buffer[0];
+}
+
+static void
+put_nalu_size(unsigned char *buffer,
+              unsigned int size_len,
+              uint64_t nalu_size) {
+  if (4 == size_len)
+    put_uint32_be(buffer, nalu_size);
+  else if (3 == size_len)
+    put_uint24_be(buffer, nalu_size);
+  else if (2 == size_len)
+    put_uint16_be(buffer, nalu_size);
+  else
+    buffer[0] = nalu_size;
+}
+
+static size_t
+count_nalus(unsigned char const *buffer,
+            size_t size,
+            unsigned int size_len) {
+  size_t pos = 0, num = 0;
+
+  while ((pos + size_len) <= size) {
+    pos += size_len + get_nalu_size(&buffer[pos], size_len);
+    ++num;
+  }
+
+  return num;
+}
+
+/** \brief Rewrite a frame consisting of size-prefixed NALUs in place
+
+   Filler NALUs are dropped, and the size fields are converted from \c
+   src_size_len to \c dst_size_len bytes. A NALU is considered to be a
+   filler NALU if the bits of its first byte selected by \c
+   nalu_type_mask equal \c filler_nalu_type.
+
+   All of this is done in a single pass over the frame. Each NALU is
+   moved at most once. The buffer is only reallocated if the size
+   fields grow. In that case the frame is first moved to the end of the
+   enlarged buffer so that writing can never overtake reading.
+
+   Bytes following the last complete size field are kept if the size
+   length doesn't change and dropped otherwise. A last NALU that is
+   shorter than its size field claims is kept but truncated.
+
+   \return \c false if a NALU is too big for \c dst_size_len. The
+     frame's content is undefined in that case.
+*/
+bool
+rewrite_nalus(memory_c &data,
+              unsigned int src_size_len,
+              unsigned int dst_size_len,
+              unsigned char nalu_type_mask,
+              unsigned char filler_nalu_type) {
+  auto buffer = data.get_buffer();
+  auto size   = data.get_size();
+
+  if (!buffer || !size)
+    return true;
+
+  size_t src_pos = 0;
+
+  if (dst_size_len > src_size_len) {
+    src_pos = count_nalus(buffer, size, src_size_len) * (dst_size_len - src_size_len);
+    data.resize(src_pos + size);
+    buffer  = data.get_buffer();
+    memmove(&buffer[src_pos], buffer, size);
+  }
+
+  auto end            = src_pos + size;
+  auto max_nalu_size  = 4 <= dst_size_len ? std::numeric_limits<uint32_t>::max() : (1ull << (8 * dst_size_len)) - 1;
+  size_t dst_pos      = 0;
+
+  while ((src_pos + src_size_len) <= end) {
+    auto nalu_size = std::min<uint64_t>(get_nalu_size(&buffer[src_pos], src_size_len), end - src_pos - src_size_len);
+    auto is_filler = nalu_size && ((buffer[src_pos + src_size_len] & nalu_type_mask) == filler_nalu_type);
+
+    if (!is_filler) {
+      if (src_size_len == dst_size_len) {
+        if (dst_pos != src_pos)
+          memmove(&buffer[dst_pos], &buffer[src_pos], src_size_len + nalu_size);
+
+      } else {
+        if (nalu_size > max_nalu_size)
+          return false;
+
+        memmove(&buffer[dst_pos + dst_size_len], &buffer[src_pos + src_size_len], nalu_size);
+        put_nalu_size(&buffer[dst_pos], dst_size_len, nalu_size);
+      }
+
+      dst_pos += dst_size_len + nalu_size;
+    }
+
+    src_pos += src_size_len + nalu_size;
+  }
+
+  if ((src_size_len == dst_size_len) && (src_pos < end)) {
+    if (dst_pos != src_pos)
+      memmove(&buffer[dst_pos], &buffer[src_pos], end - src_pos);
+    dst_pos += end - src_pos;
+  }
+
+  if (dst_pos != data.get_size())
+    data.resize(dst_pos);
+
+  return true;
+}
+
+/** \brief Split an Annex B byte stream into NALUs
+
+   The stream consists of the bytes left over from the previous call
+   (\c unparsed_buffer) followed by \c buffer. Each NALU that is
+   followed by another start code is passed to \c handle_nalu together
+   with the position of its start code relative to the beginning of
+   \c unparsed_buffer. The start codes themselves are not part of the
+   NALUs.
+
+   Only \c buffer and the last three bytes before it are searched for
+   start codes; the rest has already been searched by the previous
+   call. NALUs lying completely within \c buffer are not copied. The
+   memory passed to \c handle_nalu refers to \c buffer directly in
+   that case and is only valid during the call. Handlers that want to
+   keep such a NALU around must \c grab() it.
+
+   On return \c unparsed_buffer contains everything from the last start
+   code found onwards, or all bytes if no start code has been found at
+   all.
+
+   \return The position of the first byte kept in \c unparsed_buffer
+     relative to the beginning of the old \c unparsed_buffer.
+*/
+size_t
+split_nalus(memory_cptr &unparsed_buffer,
+            unsigned char *buffer,
+            size_t size,
+            std::function<void(memory_cptr &, size_t)> const &handle_nalu) {
+  auto tail      = unparsed_buffer ? unparsed_buffer->get_buffer() : nullptr;
+  auto tail_size = unparsed_buffer ? unparsed_buffer->get_size()   : 0;
+
+  auto byte_at   = [=](size_t pos) {
+    return pos < tail_size ? tail[pos] : buffer[pos - tail_size];
+  };
+
+  auto copy      = [=](size_t pos, size_t copy_size) -> memory_cptr {
+    auto mem       = memory_c::alloc(copy_size);
+    auto from_tail = std::min(copy_size, tail_size - pos);
+    memcpy(mem->get_buffer(),             tail + pos, from_tail);
+    memcpy(mem->get_buffer() + from_tail, buffer,     copy_size - from_tail);
+    return mem;
+  };
+
+  // The left-over bytes start with a start code unless none has been
+  // found yet.
+  auto found                  = (3 <= tail_size) && !tail[0] && !tail[1] && ((1 == tail[2]) || ((4 <= tail_size) && !tail[2] && (1 == tail[3])));
+  size_t previous_pos         = 0;
+  size_t previous_marker_size = !found ? 0 : 1 == tail[2] ? 3 : 4;
+  auto end                    = buffer + size;
+  auto ptr                    = buffer;
+
+  while (ptr < end) {
+    auto one = static_cast<unsigned char *>(memchr(ptr, 1, end - ptr));
+    if (!one)
+      break;
+
+    ptr      = one + 1;
+    auto pos = tail_size + (one - buffer);
+
+    if ((2 > pos) || byte_at(pos - 1) || byte_at(pos - 2))
+      continue;
+
+    size_t marker_size = (3 <= pos) && !byte_at(pos - 3) ? 4 : 3;
+    auto marker_pos    = pos + 1 - marker_size;
+
+    if (found) {
+      auto nalu_pos  = previous_pos + previous_marker_size;
+      auto nalu_size = marker_pos - nalu_pos;
+      auto nalu      = nalu_pos >= tail_size ? std::make_shared<memory_c>(buffer + nalu_pos - tail_size, nalu_size, false) : copy(nalu_pos, nalu_size);
+
+      handle_nalu(nalu, previous_pos);
+    }
+
+    found                = true;
+    previous_pos         = marker_pos;
+    previous_marker_size = marker_size;
+  }
+
+  auto new_size = tail_size + size - previous_pos;
+
+  if (!new_size)
+    unparsed_buffer.reset();
+
+  else if (!previous_pos && unparsed_buffer)
+    unparsed_buffer->add(buffer, size);
+
+  else if (previous_pos >= tail_size)
+    unparsed_buffer = memory_c::clone(buffer + previous_pos - tail_size, new_size);
+
+  else
+    unparsed_buffer = copy(previous_pos, new_size);
+
+  return previous_pos;
+}
+
+}}
@@ -0,0 +1,27 @@
+/** MPEG helper functions shared by the AVC and HEVC code
+
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   \file
+
+   \author Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_COMMON_MPEG_H
+#define MTX_COMMON_MPEG_H
+
+#include "common/common_pch.h"
+
+namespace mtx { namespace mpeg {
+
+bool rewrite_nalus(memory_c &data, unsigned int src_size_len, unsigned int dst_size_len, unsigned char nalu_type_mask, unsigned char filler_nalu_type);
+size_t split_nalus(memory_cptr &unparsed_buffer, unsigned char *buffer, size_t size, std::function<void(memory_cptr &, size_t)> const &handle_nalu);
+
+}}
+
+#endif  // MTX_COMMON_MPEG_H
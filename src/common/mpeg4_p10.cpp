@@ -28,6 +28,7 @@
 #include "common/hacks.h"
 #include "common/math.h"
 #include "common/mm_io.h"
+#include "common/mpeg.h"
 #include "common/mpeg4_p10.h"
 #include "common/strings/formatting.h"
 
@@ -99,15 +100,13 @@ avcc_c::parse_pps_list(bool ignore_errors) {
   m_pps_info_list.clear();
   for (auto &pps: m_pps_list) {
     pps_info_t pps_info;
-    auto pps_as_rbsp = pps->clone();
-    nalu_to_rbsp(pps_as_rbsp);
 
     if (ignore_errors) {
       try {
-        parse_pps(pps_as_rbsp, pps_info);
+        parse_pps(pps, pps_info);
       } catch (mtx::mm_io::end_of_file_x &) {
       }
-    } else if (!parse_pps(pps_as_rbsp, pps_info))
+    } else if (!parse_pps(pps, pps_info))
       return false;
 
     m_pps_info_list.push_back(pps_info);
@@ -785,7 +784,7 @@ bool
 mpeg4::p10::parse_pps(memory_cptr &buffer,
                       pps_info_t &pps) {
   try {
-    bit_reader_c r(buffer->get_buffer(), buffer->get_size());
+    nalu_bit_reader_c r(buffer->get_buffer(), buffer->get_size());
 
     memset(&pps, 0, sizeof(pps));
 
@@ -1058,63 +1057,16 @@ mpeg4::p10::avc_es_parser_c::remove_trailing_zero_bytes(memory_c &memory) {
 void
 mpeg4::p10::avc_es_parser_c::add_bytes(unsigned char *buffer,
                                        size_t size) {
-  memory_slice_cursor_c cursor;
-  int marker_size              = 0;
-  int previous_marker_size     = 0;
-  int previous_pos             = -1;
   uint64_t previous_parsed_pos = m_parsed_position;
 
-  if (m_unparsed_buffer && (0 != m_unparsed_buffer->get_size()))
-    cursor.add_slice(m_unparsed_buffer);
-  cursor.add_slice(buffer, size);
-
-  if (3 <= cursor.get_remaining_size()) {
-    uint32_t marker =                               1 << 24
-                    | (unsigned int)cursor.get_char() << 16
-                    | (unsigned int)cursor.get_char() <<  8
-                    | (unsigned int)cursor.get_char();
-
-    while (1) {
-      if (NALU_START_CODE == marker)
-        marker_size = 4;
-      else if (NALU_START_CODE == (marker & 0x00ffffff))
-        marker_size = 3;
-
-      if (0 != marker_size) {
-        if (-1 != previous_pos) {
-          int new_size = cursor.get_position() - marker_size - previous_pos - previous_marker_size;
-          memory_cptr nalu(new memory_c(safemalloc(new_size), new_size, true));
-          cursor.copy(nalu->get_buffer(), previous_pos + previous_marker_size, new_size);
-          m_parsed_position = previous_parsed_pos + previous_pos;
-          remove_trailing_zero_bytes(*nalu);
-          handle_nalu(nalu);
-        }
-        previous_pos         = cursor.get_position() - marker_size;
-        previous_marker_size = marker_size;
-        marker_size          = 0;
-      }
-
-      if (!cursor.char_available())
-        break;
-
-      marker <<= 8;
-      marker  |= (unsigned int)cursor.get_char();
-    }
-  }
-
-  if (-1 == previous_pos)
-    previous_pos = 0;
+  auto unparsed_pos = mtx::mpeg::split_nalus(m_unparsed_buffer, buffer, size, [this, previous_parsed_pos](memory_cptr &nalu, size_t marker_pos) {
+    m_parsed_position = previous_parsed_pos + marker_pos;
+    remove_trailing_zero_bytes(*nalu);
+    handle_nalu(nalu);
+  });
 
   m_stream_position += size;
-  m_parsed_position  = previous_parsed_pos + previous_pos;
-
-  int new_size = cursor.get_size() - previous_pos;
-  if (0 != new_size) {
-    m_unparsed_buffer = memory_cptr(new memory_c(safemalloc(new_size), new_size, true));
-    cursor.copy(m_unparsed_buffer->get_buffer(), previous_pos, new_size);
-
-  } else
-    m_unparsed_buffer.reset();
+  m_parsed_position  = previous_parsed_pos + unparsed_pos;
 }
 
 void
@@ -1224,6 +1176,7 @@ mpeg4::p10::avc_es_parser_c::flush_unhandled_nalus() {
 void
 mpeg4::p10::avc_es_parser_c::handle_slice_nalu(memory_cptr &nalu) {
   if (!m_avcc_ready) {
+    nalu->grab();
     m_unhandled_nalus.push_back(nalu);
     return;
   }
@@ -1337,10 +1290,10 @@ void
 mpeg4::p10::avc_es_parser_c::handle_pps_nalu(memory_cptr &nalu) {
   pps_info_t pps_info;
 
-  nalu_to_rbsp(nalu);
   if (!parse_pps(nalu, pps_info))
     return;
-  rbsp_to_nalu(nalu);
+
+  nalu->grab();
 
   size_t i;
   for (i = 0; m_pps_info_list.size() > i; ++i)
@@ -1366,9 +1319,7 @@ mpeg4::p10::avc_es_parser_c::handle_pps_nalu(memory_cptr &nalu) {
 void
 mpeg4::p10::avc_es_parser_c::handle_sei_nalu(memory_cptr &nalu) {
   try {
-    nalu_to_rbsp(nalu);
-
-    bit_reader_c r(nalu->get_buffer(), nalu->get_size());
+    nalu_bit_reader_c r(nalu->get_buffer(), nalu->get_size());
 
     r.skip_bits(8);
 
@@ -1457,7 +1408,7 @@ bool
 mpeg4::p10::avc_es_parser_c::parse_slice(memory_cptr &buffer,
                                          slice_info_t &si) {
   try {
-    bit_reader_c r(buffer->get_buffer(), buffer->get_size());
+    nalu_bit_reader_c r(buffer->get_buffer(), buffer->get_size());
 
     memset(&si, 0, sizeof(si));
 
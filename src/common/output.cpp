@@ -13,6 +13,7 @@
 
 #include "common/common_pch.h"
 
+#include <mutex>
 #include <sstream>
 
 #include "common/ebml.h"
@@ -33,6 +34,10 @@ std::shared_ptr<mm_io_c> g_mm_stdio   = std::shared_ptr<mm_io_c>(new mm_stdio_c)
 
 static mxmsg_handler_t s_mxmsg_info_handler, s_mxmsg_warning_handler, s_mxmsg_error_handler;
 
+// Messages may be issued from several threads (e.g. mkvextract's
+// workers).
+static std::mutex s_mxmsg_mutex;
+
 void
 redirect_stdio(const mm_io_cptr &stdio) {
   g_mm_stdio            = stdio;
@@ -66,6 +71,8 @@ mxmsg(unsigned int level,
   if (g_suppress_info && (MXMSG_INFO == level))
     return;
 
+  std::lock_guard<std::mutex> lock{s_mxmsg_mutex};
+
   if ('\n' == message[0]) {
     message.erase(0, 1);
     g_mm_stdio->puts("\n");
@@ -124,6 +131,7 @@ default_mxwarn(unsigned int,
 
   mxmsg(MXMSG_WARNING, warning);
 
+  std::lock_guard<std::mutex> lock{s_mxmsg_mutex};
   g_warning_issued = true;
 }
 
@@ -216,3 +216,60 @@ from_hex(const std::string &data) {
 
   return value;
 }
+
+/** \brief Parse a plain decimal number like "41.708333" without locale
+   switching or temporary strings
+
+   Numbers with at most 15 significant digits and without an exponent
+   are converted exactly: both the integral mantissa and the power of
+   ten are representable as doubles, and a single division is rounded
+   correctly. Everything else is handed to the generic \c parse_number.
+*/
+bool
+parse_number(char const *begin,
+             char const *end,
+             double &value) {
+  static double const s_powers_of_ten[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+  };
+
+  auto p          = begin;
+  auto negative   = (p < end) && ('-' == *p);
+  auto mantissa   = uint64_t{};
+  auto num_digits = 0u, num_significant_digits = 0u, num_fraction_digits = 0u;
+  auto in_fraction = false;
+
+  if (negative)
+    ++p;
+
+  for (; p < end; ++p) {
+    if (('.' == *p) && !in_fraction) {
+      in_fraction = true;
+      continue;
+    }
+
+    if (('0' > *p) || ('9' < *p))
+      break;
+
+    ++num_digits;
+    if (in_fraction)
+      ++num_fraction_digits;
+    if (mantissa || ('0' != *p))
+      ++num_significant_digits;
+
+    mantissa = mantissa * 10 + (*p - '0');
+
+    if (15 < num_significant_digits)
+      break;
+  }
+
+  if ((p != end) || !num_digits || (22 < num_fraction_digits))
+    return parse_number(std::string{begin, end}, value);
+
+  value = static_cast<double>(mantissa) / s_powers_of_ten[num_fraction_digits];
+  if (negative)
+    value = -value;
+
+  return true;
+}
@@ -72,6 +72,8 @@ parse_number(StrT const &string,
   return parse_number<StrT, float>(string, value);
 }
 
+bool parse_number(char const *begin, char const *end, double &value);
+
 extern std::string timecode_parser_error;
 extern bool parse_timecode(const std::string &s, int64_t &timecode, bool allow_negative = false);
 
@@ -381,14 +381,23 @@ ebml_converter_c::to_ebml_recursively(EbmlMaster &parent,
     convert_node_or_attribute_to_ebml(*converted_master, node, *attribute, handled_attributes);
   }
 
-  for (auto child : node) {
-    if (child.type() != pugi::node_element)
-      continue;
+  auto child = node.first_child();
+  while (child) {
+    auto next_child = child.next_sibling();
+
+    if (child.type() == pugi::node_element) {
+      if (!converted_master)
+        throw invalid_child_node_x{ node.first_child().name(), node.name(), node.offset_debug() };
 
-    if (converted_master)
       to_ebml_recursively(*converted_master, child);
-    else
-      throw invalid_child_node_x{ node.first_child().name(), node.name(), node.offset_debug() };
+
+      // Converted nodes are not needed anymore. Freeing them right away
+      // lets the EBML tree re-use the DOM's memory instead of both
+      // having to fit into memory at the same time.
+      node.remove_child(child);
+    }
+
+    child = next_child;
   }
 }
 
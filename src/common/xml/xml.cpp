@@ -13,8 +13,6 @@
 
 #include "common/common_pch.h"
 
-#include <sstream>
-
 #include "common/mm_io_x.h"
 #include "common/xml/xml.h"
 
@@ -61,10 +59,18 @@ load_file(std::string const &file_name,
           boost::optional<int64_t> max_read_size) {
   auto af_in = mm_file_io_c::open(file_name, MODE_READ);
   mm_text_io_c in(af_in.get(), false);
-  std::string content;
-  auto bytes_to_read = (max_read_size ? std::min(in.get_size(), *max_read_size) : in.get_size()) - in.get_byte_order_length();
-
-  if (in.read(content, bytes_to_read) != bytes_to_read)
+  size_t bytes_to_read = (max_read_size ? std::min(in.get_size(), *max_read_size) : in.get_size()) - in.get_byte_order_length();
+
+  // The content is read into a buffer that pugixml parses in place and
+  // takes ownership of. Names and values in the DOM point into that
+  // buffer, so the file's content is held in memory only once instead
+  // of in several intermediate copies.
+  auto allocate = pugi::get_memory_allocation_function();
+  std::unique_ptr<char, pugi::deallocation_function> content{static_cast<char *>(allocate(bytes_to_read + 1)), pugi::get_memory_deallocation_function()};
+  if (!content)
+    throw std::bad_alloc{};
+
+  if (in.read(content.get(), bytes_to_read) != bytes_to_read)
     throw mtx::mm_io::end_of_file_x{};
 
   if (BO_NONE == in.get_byte_order()) {
@@ -74,14 +80,26 @@ load_file(std::string const &file_name,
                              "encoding \\s* = \\s*" // encoding attribute
                              "\" ( [^\"]+ ) \"",    // attribute value
                              boost::regex::perl | boost::regex::mod_x | boost::regex::icase);
-    boost::match_results<std::string::const_iterator> matches;
-    if (boost::regex_search(content, matches, encoding_re))
-      content = charset_converter_c::init(matches[1].str())->utf8(content);
+    boost::match_results<char const *> matches;
+    if (boost::regex_search(static_cast<char const *>(content.get()), content.get() + bytes_to_read, matches, encoding_re)) {
+      auto converter = charset_converter_c::init(matches[1].str());
+      auto source    = std::string{content.get(), bytes_to_read};
+      content.reset();
+
+      auto converted = converter->utf8(source);
+      source         = std::string{};
+      bytes_to_read  = converted.length();
+
+      content.reset(static_cast<char *>(allocate(bytes_to_read + 1)));
+      if (!content)
+        throw std::bad_alloc{};
+
+      memcpy(content.get(), converted.c_str(), bytes_to_read);
+    }
   }
 
-  std::stringstream scontent(content);
-  auto doc = std::make_shared<pugi::xml_document>();
-  auto result = doc->load(scontent, options);
+  auto doc    = std::make_shared<pugi::xml_document>();
+  auto result = doc->load_buffer_inplace_own(content.release(), bytes_to_read, options);
   if (!result)
     throw xml_parser_x{result};
 
@@ -125,25 +125,12 @@ handle_attachments(KaxAttachments *atts,
 }
 
 void
-extract_attachments(const std::string &file_name,
-                    std::vector<track_spec_t> &tracks,
-                    kax_analyzer_c::parse_mode_e parse_mode) {
+extract_attachments(kax_analyzer_c &analyzer,
+                    std::vector<track_spec_t> &tracks) {
   if (tracks.empty())
     mxerror(Y("Nothing to do.\n"));
 
-  kax_analyzer_cptr analyzer;
-
-  // open input file
-  try {
-    analyzer = kax_analyzer_cptr(new kax_analyzer_c(file_name));
-    if (!analyzer->process(parse_mode, MODE_READ, true))
-      throw false;
-  } catch (mtx::mm_io::exception &ex) {
-    show_error(boost::format(Y("The file '%1%' could not be opened for reading: %2%.\n")) % file_name % ex);
-    return;
-  }
-
-  ebml_master_cptr attachments_m(analyzer->read_all(EBML_INFO(KaxAttachments)));
+  ebml_master_cptr attachments_m(analyzer.read_all(EBML_INFO(KaxAttachments)));
   KaxAttachments *attachments = dynamic_cast<KaxAttachments *>(attachments_m.get());
   if (attachments)
     handle_attachments(attachments, tracks);
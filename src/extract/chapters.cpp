@@ -35,33 +35,23 @@
 using namespace libmatroska;
 
 void
-extract_chapters(const std::string &file_name,
+extract_chapters(kax_analyzer_c &analyzer,
                  bool chapter_format_simple,
-                 kax_analyzer_c::parse_mode_e parse_mode) {
-  kax_analyzer_cptr analyzer;
-
-  // open input file
-  try {
-    analyzer = kax_analyzer_cptr(new kax_analyzer_c(file_name));
-    if (!analyzer->process(parse_mode, MODE_READ, true))
-      throw false;
-  } catch (mtx::mm_io::exception &ex) {
-    show_error(boost::format(Y("The file '%1%' could not be opened for reading: %2%.\n")) % file_name % ex);
-    return;
-  }
-
-  ebml_master_cptr master = analyzer->read_all(EBML_INFO(KaxChapters));
+                 const std::string &output_file_name) {
+  ebml_master_cptr master = analyzer.read_all(EBML_INFO(KaxChapters));
   if (!master)
     return;
 
   KaxChapters *chapters = dynamic_cast<KaxChapters *>(master.get());
   assert(chapters);
 
+  auto out = open_output_file(output_file_name);
+
   if (!chapter_format_simple)
-    mtx::xml::ebml_chapters_converter_c::write_xml(*chapters, *g_mm_stdio);
+    mtx::xml::ebml_chapters_converter_c::write_xml(*chapters, *out);
 
   else {
     int dummy = 1;
-    write_chapters_simple(dummy, chapters, g_mm_stdio.get());
+    write_chapters_simple(dummy, chapters, out.get());
   }
 }
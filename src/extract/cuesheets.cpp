@@ -194,23 +194,11 @@ write_cuesheet(std::string file_name,
 }
 
 void
-extract_cuesheet(const std::string &file_name,
-                 kax_analyzer_c::parse_mode_e parse_mode) {
-  kax_analyzer_cptr analyzer;
-
-  // open input file
-  try {
-    analyzer = kax_analyzer_cptr(new kax_analyzer_c(file_name));
-    if (!analyzer->process(parse_mode, MODE_READ, true))
-      throw false;
-  } catch (mtx::mm_io::exception &ex) {
-    show_error(boost::format(Y("The file '%1%' could not be opened for reading: %2%.\n")) % file_name % ex);
-    return;
-  }
-
+extract_cuesheet(kax_analyzer_c &analyzer,
+                 const std::string &output_file_name) {
   KaxChapters all_chapters;
-  ebml_master_cptr chapters_m(analyzer->read_all(EBML_INFO(KaxChapters)));
-  ebml_master_cptr tags_m(    analyzer->read_all(EBML_INFO(KaxTags)));
+  ebml_master_cptr chapters_m(analyzer.read_all(EBML_INFO(KaxChapters)));
+  ebml_master_cptr tags_m(    analyzer.read_all(EBML_INFO(KaxTags)));
   KaxChapters *chapters = dynamic_cast<KaxChapters *>(chapters_m.get());
   KaxTags *all_tags     = dynamic_cast<KaxTags *>(    tags_m.get());
 
@@ -227,7 +215,7 @@ extract_cuesheet(const std::string &file_name,
         all_chapters.PushElement(*edition_entry);
   }
 
-  write_cuesheet(file_name, all_chapters, *all_tags, -1, *g_mm_stdio);
+  write_cuesheet(analyzer.get_file_name(), all_chapters, *all_tags, -1, *open_output_file(output_file_name));
 
   while (all_chapters.ListSize() > 0)
     all_chapters.Remove(0);
@@ -13,6 +13,7 @@
 
 #include "common/common_pch.h"
 
+#include "common/command_line.h"
 #include "common/ebml.h"
 #include "common/strings/formatting.h"
 #include "common/strings/parsing.h"
@@ -23,6 +24,7 @@
 extract_cli_parser_c::extract_cli_parser_c(const std::vector<std::string> &args)
   : cli_parser_c(args)
   , m_num_unknown_args(0)
+  , m_current_mode(nullptr)
 {
   set_default_values();
 }
@@ -40,6 +42,7 @@ extract_cli_parser_c::set_default_values() {
 void
 extract_cli_parser_c::init_parser() {
   add_information(YT("mkvextract <mode> <source-filename> [options] <extraction-spec>"));
+  add_information(YT("mkvextract <source-filename> <mode1> [options] <extraction-spec1> [<mode2> [options] <extraction-spec2> ...]"));
 
   add_section_header(YT("Usage"));
   add_information(YT("mkvextract tracks <inname> [options] [TID1:out1 [TID2:out2 ...]]"));
@@ -55,6 +58,10 @@ extract_cli_parser_c::init_parser() {
   add_information(YT("The first word tells mkvextract what to extract. The second must be the source file. "
                      "There are few global options that can be used with all modes. "
                      "All other options depend on the mode."));
+  add_information(YT("Alternatively the source file can be given first followed by several modes, each with its own options and extraction specs. "
+                     "In this case all requested items are extracted during a single pass over the source file. "
+                     "For the modes 'tags', 'chapters' and 'cuesheet' the extraction spec is the name of the output file; "
+                     "without it the result is written to the standard output."));
 
   add_section_header(YT("Global options"));
   OPT("f|parse-fully",    set_parse_fully,      YT("Parse the whole file instead of relying on the index."));
@@ -116,6 +123,10 @@ extract_cli_parser_c::init_parser() {
 
   add_information(YT("mkvextract timecodes_v2 \"a movie.mkv\" 1:timecodes_track1.txt"));
 
+  add_section_header(YT("Extracting several items at once"));
+
+  add_information(YT("mkvextract \"a movie.mkv\" tracks 1:video.h264 2:audio.ac3 timecodes_v2 1:timecodes_track1.txt attachments 1:font.ttf chapters chapters.xml tags tags.xml"));
+
   add_hook(cli_parser_c::ht_unknown_option, std::bind(&extract_cli_parser_c::set_mode_or_extraction_spec, this));
 }
 
@@ -123,10 +134,12 @@ extract_cli_parser_c::init_parser() {
 
 void
 extract_cli_parser_c::assert_mode(options_c::extraction_mode_e mode) {
-  if      ((options_c::em_tracks   == mode) && (m_options.m_extraction_mode != mode))
+  auto current_mode = m_current_mode ? m_current_mode->m_extraction_mode : options_c::em_unknown;
+
+  if      ((options_c::em_tracks   == mode) && (current_mode != mode))
     mxerror(boost::format(Y("'%1%' is only allowed when extracting tracks.\n"))   % m_current_arg);
 
-  else if ((options_c::em_chapters == mode) && (m_options.m_extraction_mode != mode))
+  else if ((options_c::em_chapters == mode) && (current_mode != mode))
     mxerror(boost::format(Y("'%1%' is only allowed when extracting chapters.\n")) % m_current_arg);
 }
 
@@ -169,25 +182,35 @@ extract_cli_parser_c::set_fullraw() {
 void
 extract_cli_parser_c::set_simple() {
   assert_mode(options_c::em_chapters);
-  m_options.m_simple_chapter_format = true;
+  m_current_mode->m_simple_chapter_format = true;
 }
 
 void
 extract_cli_parser_c::set_mode_or_extraction_spec() {
   ++m_num_unknown_args;
 
-  if (1 == m_num_unknown_args)
-    set_extraction_mode();
+  // Two syntaxes are supported: the traditional "<mode> <source-file>
+  // [specs]" and "<source-file> <mode1> [specs1] [<mode2> [specs2] ...]"
+  // which extracts several items during a single pass over the file.
+  if (1 == m_num_unknown_args) {
+    m_options.m_legacy_syntax = options_c::em_unknown != get_extraction_mode(m_current_arg);
+    if (m_options.m_legacy_syntax)
+      set_extraction_mode();
+    else
+      m_options.m_file_name = m_current_arg;
 
-  else if (2 == m_num_unknown_args)
+  } else if ((2 == m_num_unknown_args) && m_options.m_legacy_syntax)
     m_options.m_file_name = m_current_arg;
 
+  else if (!m_options.m_legacy_syntax && (!m_current_mode || (options_c::em_unknown != get_extraction_mode(m_current_arg))))
+    set_extraction_mode();
+
   else
     add_extraction_spec();
 }
 
-void
-extract_cli_parser_c::set_extraction_mode() {
+options_c::extraction_mode_e
+extract_cli_parser_c::get_extraction_mode(const std::string &name) {
   static struct {
     const char *name;
     options_c::extraction_mode_e extraction_mode;
@@ -203,26 +226,52 @@ extract_cli_parser_c::set_extraction_mode() {
 
   int i;
   for (i = 0; s_mode_map[i].name; ++i)
-    if (m_current_arg == s_mode_map[i].name) {
-      m_options.m_extraction_mode = s_mode_map[i].extraction_mode;
-      return;
-    }
+    if (name == s_mode_map[i].name)
+      return s_mode_map[i].extraction_mode;
 
-  mxerror(boost::format(Y("Unknown mode '%1%'.\n")) % m_current_arg);
+  return options_c::em_unknown;
+}
+
+void
+extract_cli_parser_c::set_extraction_mode() {
+  auto extraction_mode = get_extraction_mode(m_current_arg);
+  if (options_c::em_unknown == extraction_mode)
+    mxerror(boost::format(Y("Unknown mode '%1%'.\n")) % m_current_arg);
+
+  // Specifying the same mode twice continues adding specs to the
+  // existing one.
+  m_current_mode = m_options.find_mode(extraction_mode);
+  if (!m_current_mode) {
+    m_options.m_modes.push_back(options_c::mode_options_c{extraction_mode});
+    m_current_mode = &m_options.m_modes.back();
+  }
+
+  set_default_values();
 }
 
 void
 extract_cli_parser_c::add_extraction_spec() {
-  if (   (options_c::em_tracks       != m_options.m_extraction_mode)
-      && (options_c::em_timecodes_v2 != m_options.m_extraction_mode)
-      && (options_c::em_attachments  != m_options.m_extraction_mode))
+  auto extraction_mode = m_current_mode->m_extraction_mode;
+
+  if (   !m_options.m_legacy_syntax
+      && m_current_mode->m_output_file_name.empty()
+      && (   (options_c::em_chapters == extraction_mode)
+          || (options_c::em_cuesheet == extraction_mode)
+          || (options_c::em_tags     == extraction_mode))) {
+    m_current_mode->m_output_file_name = m_current_arg;
+    return;
+  }
+
+  if (   (options_c::em_tracks       != extraction_mode)
+      && (options_c::em_timecodes_v2 != extraction_mode)
+      && (options_c::em_attachments  != extraction_mode))
     mxerror(boost::format(Y("Unrecognized command line option '%1%'.\n")) % m_current_arg);
 
   boost::regex s_track_id_re("^(\\d+)(:(.+))?$", boost::regex::perl);
 
   boost::smatch matches;
   if (!boost::regex_search(m_current_arg, matches, s_track_id_re)) {
-    if (options_c::em_attachments == m_options.m_extraction_mode)
+    if (options_c::em_attachments == extraction_mode)
       mxerror(boost::format(Y("Invalid attachment ID/file name specification in argument '%1%'.\n")) % m_current_arg);
     else
       mxerror(boost::format(Y("Invalid track ID/file name specification in argument '%1%'.\n")) % m_current_arg);
@@ -232,16 +281,16 @@ extract_cli_parser_c::add_extraction_spec() {
 
   parse_number(matches[1].str(), track.tid);
 
-  if (m_used_tids[track.tid])
-    mxerror(boost::format(Y("The ID '%1%' has already been used for another output file.\n")) % track.tid);
-  m_used_tids[track.tid] = true;
+  for (auto const &existing_track : m_current_mode->m_tracks)
+    if (existing_track.tid == track.tid)
+      mxerror(boost::format(Y("The ID '%1%' has already been used for another output file.\n")) % track.tid);
 
   std::string output_file_name;
   if (matches[3].matched)
     output_file_name = matches[3].str();
 
   if (output_file_name.empty()) {
-    if (options_c::em_attachments == m_options.m_extraction_mode)
+    if (options_c::em_attachments == extraction_mode)
       mxinfo(Y("No output file name specified, will use attachment name.\n"));
     else
       mxerror(boost::format(Y("Missing output file name in argument '%1%'.\n")) % m_current_arg);
@@ -252,7 +301,7 @@ extract_cli_parser_c::add_extraction_spec() {
   track.extract_cuesheet       = m_extract_cuesheet;
   track.extract_blockadd_level = m_extract_blockadd_level;
   track.target_mode            = m_target_mode;
-  m_options.m_tracks.push_back(track);
+  m_current_mode->m_tracks.push_back(track);
 
   set_default_values();
 }
@@ -263,5 +312,8 @@ extract_cli_parser_c::run() {
 
   parse_args();
 
+  if (m_options.m_file_name.empty() || m_options.m_modes.empty())
+    usage(2);
+
   return m_options;
 }
@@ -13,8 +13,6 @@
 
 #include "common/common_pch.h"
 
-#include <unordered_map>
-
 #include "common/cli_parser.h"
 #include "extract/mkvextract.h"
 #include "extract/options.h"
@@ -23,14 +21,13 @@ class extract_cli_parser_c: public cli_parser_c {
 protected:
   options_c m_options;
   int m_num_unknown_args;
+  options_c::mode_options_c *m_current_mode;
 
   std::string m_charset;
   bool m_extract_cuesheet;
   int m_extract_blockadd_level;
   track_spec_t::target_mode_e m_target_mode;
 
-  std::unordered_map<int64_t, bool> m_used_tids;
-
 public:
   extract_cli_parser_c(const std::vector<std::string> &args);
 
@@ -52,6 +49,8 @@ protected:
   void set_mode_or_extraction_spec();
   void set_extraction_mode();
   void add_extraction_spec();
+
+  static options_c::extraction_mode_e get_extraction_mode(const std::string &name);
 };
 
 #endif // MTX_EXTRACT_EXTRACT_CLI_PARSER_H
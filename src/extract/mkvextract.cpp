@@ -19,6 +19,8 @@
 #include "common/chapters/chapters.h"
 #include "common/command_line.h"
 #include "common/mm_io.h"
+#include "common/mm_io_x.h"
+#include "common/mm_write_buffer_io.h"
 #include "common/strings/parsing.h"
 #include "common/translation.h"
 #include "common/version.h"
@@ -29,15 +31,6 @@ using namespace libmatroska;
 
 #define NAME "mkvextract"
 
-enum operation_mode_e {
-  MODE_TRACKS,
-  MODE_TAGS,
-  MODE_ATTACHMENTS,
-  MODE_CHAPTERS,
-  MODE_CUESHEET,
-  MODE_TIMECODES_V2,
-};
-
 void
 show_element(EbmlElement *l,
              int level,
@@ -74,6 +67,28 @@ setup(char **argv) {
   version_info = get_version_info("mkvextract", vif_full);
 }
 
+mm_io_cptr
+open_output_file(const std::string &file_name) {
+  if (file_name.empty())
+    return g_mm_stdio;
+
+  try {
+    return mm_write_buffer_io_c::open(file_name, 128 * 1024);
+
+  } catch (mtx::mm_io::exception &ex) {
+    mxerror(boost::format(Y("The file '%1%' could not be opened for writing: %2%.\n")) % file_name % ex);
+  }
+
+  return mm_io_cptr{};
+}
+
+static std::vector<track_spec_t>
+collect_track_specs(options_c &options,
+                    options_c::extraction_mode_e extraction_mode) {
+  auto mode = options.find_mode(extraction_mode);
+  return mode ? mode->m_tracks : std::vector<track_spec_t>{};
+}
+
 int
 main(int argc,
      char **argv) {
@@ -81,29 +96,66 @@ main(int argc,
 
   options_c options = extract_cli_parser_c(command_line_utf8(argc, argv)).run();
 
-  if (options_c::em_tracks == options.m_extraction_mode) {
-    extract_tracks(options.m_file_name, options.m_tracks, options.m_parse_mode);
+  auto tracks           = collect_track_specs(options, options_c::em_tracks);
+  auto timecode_tracks  = collect_track_specs(options, options_c::em_timecodes_v2);
+  auto attachments      = collect_track_specs(options, options_c::em_attachments);
+  bool needs_clusters   = options.has_mode(options_c::em_tracks) || options.has_mode(options_c::em_timecodes_v2);
+  bool needs_analyzer   = options.has_mode(options_c::em_tags)   || options.has_mode(options_c::em_attachments)
+                       || options.has_mode(options_c::em_chapters) || options.has_mode(options_c::em_cuesheet);
+
+  if (   (options.has_mode(options_c::em_tracks)       && tracks.empty())
+      || (options.has_mode(options_c::em_timecodes_v2) && timecode_tracks.empty())
+      || (options.has_mode(options_c::em_attachments)  && attachments.empty()))
+    mxerror(Y("Nothing to do.\n"));
+
+  // Open the file once. The analyzer's index is used for locating
+  // the tags, chapters and attachments and for the track headers; only
+  // the track and timecode extraction has to read all clusters, and it
+  // does so in a single pass for all requested tracks.
+  mm_io_cptr in;
+  kax_analyzer_cptr analyzer;
+  bool analyzer_ok = false;
+
+  try {
+    in          = mm_file_io_c::open(options.m_file_name);
+    analyzer    = kax_analyzer_cptr(new kax_analyzer_c(static_cast<mm_file_io_c *>(in.get())));
+    analyzer_ok = analyzer->process(options.m_parse_mode, MODE_READ, true);
+
+  } catch (mtx::mm_io::exception &ex) {
+    show_error(boost::format(Y("The file '%1%' could not be opened for reading: %2%.\n")) % options.m_file_name % ex);
+
+  } catch (mtx::kax_analyzer_x &ex) {
+    if (needs_analyzer)
+      show_error(boost::format(Y("The file '%1%' could not be opened for reading: %2%.\n")) % options.m_file_name % ex);
+  }
+
+  // Only the track and timecode extraction can do without the
+  // analyzer's index as it reads all clusters anyway.
+  if (!analyzer_ok && needs_analyzer)
+    show_error(boost::format(Y("The file '%1%' could not be opened for reading.\n")) % options.m_file_name);
+
+  if (analyzer_ok) {
+    for (auto &mode : options.m_modes) {
+      if (options_c::em_tags == mode.m_extraction_mode)
+        extract_tags(*analyzer, mode.m_output_file_name);
+
+      else if (options_c::em_attachments == mode.m_extraction_mode)
+        extract_attachments(*analyzer, attachments);
+
+      else if (options_c::em_chapters == mode.m_extraction_mode)
+        extract_chapters(*analyzer, mode.m_simple_chapter_format, mode.m_output_file_name);
+
+      else if (options_c::em_cuesheet == mode.m_extraction_mode)
+        extract_cuesheet(*analyzer, mode.m_output_file_name);
+    }
+  }
+
+  if (needs_clusters) {
+    extract_tracks(in, analyzer_ok ? analyzer.get() : nullptr, tracks, timecode_tracks);
 
     if (0 == verbose)
       mxinfo(Y("Progress: 100%\n"));
-
-  } else if (options_c::em_tags == options.m_extraction_mode)
-    extract_tags(options.m_file_name, options.m_parse_mode);
-
-  else if (options_c::em_attachments == options.m_extraction_mode)
-    extract_attachments(options.m_file_name, options.m_tracks, options.m_parse_mode);
-
-  else if (options_c::em_chapters == options.m_extraction_mode)
-    extract_chapters(options.m_file_name, options.m_simple_chapter_format, options.m_parse_mode);
-
-  else if (options_c::em_cuesheet == options.m_extraction_mode)
-    extract_cuesheet(options.m_file_name, options.m_parse_mode);
-
-  else if (options_c::em_timecodes_v2 == options.m_extraction_mode)
-    extract_timecodes(options.m_file_name, options.m_tracks, 2);
-
-  else
-    usage(2);
+  }
 
   return 0;
 }
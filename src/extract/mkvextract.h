@@ -19,7 +19,9 @@
 
 #include <ogg/ogg.h>
 
+#include <matroska/KaxBlock.h>
 #include <matroska/KaxChapters.h>
+#include <matroska/KaxCluster.h>
 #include <matroska/KaxTags.h>
 #include <matroska/KaxTracks.h>
 
@@ -51,14 +53,23 @@ show_error(const boost::format &format) {
   show_error(format.str());
 }
 
+mm_io_cptr open_output_file(const std::string &file_name);
+
 void find_and_verify_track_uids(KaxTracks &tracks, std::vector<track_spec_t> &tspecs);
 
-bool extract_tracks(const std::string &file_name, std::vector<track_spec_t> &tspecs, kax_analyzer_c::parse_mode_e parse_mode);
-void extract_tags(const std::string &file_name, kax_analyzer_c::parse_mode_e parse_mode);
-void extract_chapters(const std::string &file_name, bool chapter_format_simple, kax_analyzer_c::parse_mode_e parse_mode);
-void extract_attachments(const std::string &file_name, std::vector<track_spec_t> &tracks, kax_analyzer_c::parse_mode_e parse_mode);
-void extract_cuesheet(const std::string &file_name, kax_analyzer_c::parse_mode_e parse_mode);
+// Track and timecode extraction share one sequential pass over all clusters.
+bool extract_tracks(mm_io_cptr &in, kax_analyzer_c *analyzer, std::vector<track_spec_t> &tspecs, std::vector<track_spec_t> &timecode_tspecs);
+
+// These items are located via the analyzer's index instead of a cluster scan.
+void extract_tags(kax_analyzer_c &analyzer, const std::string &output_file_name);
+void extract_chapters(kax_analyzer_c &analyzer, bool chapter_format_simple, const std::string &output_file_name);
+void extract_attachments(kax_analyzer_c &analyzer, std::vector<track_spec_t> &tracks);
+void extract_cuesheet(kax_analyzer_c &analyzer, const std::string &output_file_name);
 void write_cuesheet(std::string file_name, KaxChapters &chapters, KaxTags &tags, int64_t tuid, mm_io_c &out);
-void extract_timecodes(const std::string &file_name, std::vector<track_spec_t> &tspecs, int version);
+
+void create_timecode_files(KaxTracks &kax_tracks, std::vector<track_spec_t> &tspecs, int version);
+void handle_timecodes_blockgroup(KaxBlockGroup &blockgroup, KaxCluster &cluster, int64_t tc_scale);
+void handle_timecodes_simpleblock(KaxSimpleBlock &simpleblock, KaxCluster &cluster);
+void close_timecode_files();
 
 #endif // MTX_MKVEXTRACT_H
@@ -15,9 +15,28 @@
 #include "extract/mkvextract.h"
 #include "extract/options.h"
 
+options_c::mode_options_c::mode_options_c(options_c::extraction_mode_e extraction_mode)
+  : m_extraction_mode(extraction_mode)
+  , m_simple_chapter_format(false)
+{
+}
+
 options_c::options_c()
-  : m_simple_chapter_format(false)
-  , m_parse_mode(kax_analyzer_c::parse_mode_fast)
-  , m_extraction_mode(options_c::em_unknown)
+  : m_parse_mode(kax_analyzer_c::parse_mode_fast)
+  , m_legacy_syntax(false)
 {
 }
+
+options_c::mode_options_c *
+options_c::find_mode(options_c::extraction_mode_e extraction_mode) {
+  for (auto &mode : m_modes)
+    if (mode.m_extraction_mode == extraction_mode)
+      return &mode;
+
+  return nullptr;
+}
+
+bool
+options_c::has_mode(options_c::extraction_mode_e extraction_mode) {
+  return !!find_mode(extraction_mode);
+}
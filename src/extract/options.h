@@ -25,15 +25,29 @@ public:
     em_tracks
   };
 
+  class mode_options_c {
+  public:
+    extraction_mode_e m_extraction_mode;
+    std::string m_output_file_name;
+    bool m_simple_chapter_format;
+
+    std::vector<track_spec_t> m_tracks;
+
+  public:
+    mode_options_c(extraction_mode_e extraction_mode);
+  };
+
   std::string m_file_name;
-  bool m_simple_chapter_format;
   kax_analyzer_c::parse_mode_e m_parse_mode;
-  extraction_mode_e m_extraction_mode;
+  bool m_legacy_syntax;
 
-  std::vector<track_spec_t> m_tracks;
+  std::vector<mode_options_c> m_modes;
 
 public:
   options_c();
+
+  mode_options_c *find_mode(extraction_mode_e extraction_mode);
+  bool has_mode(extraction_mode_e extraction_mode);
 };
 
 #endif // MTX_EXTRACT_OPTIONS_H
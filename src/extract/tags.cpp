@@ -35,26 +35,14 @@
 using namespace libmatroska;
 
 void
-extract_tags(const std::string &file_name,
-             kax_analyzer_c::parse_mode_e parse_mode) {
-  kax_analyzer_cptr analyzer;
-
-  // open input file
-  try {
-    analyzer = kax_analyzer_cptr(new kax_analyzer_c(file_name));
-    if (!analyzer->process(parse_mode, MODE_READ, true))
-      throw false;
-  } catch (mtx::mm_io::exception &ex) {
-    show_error(boost::format(Y("The file '%1%' could not be opened for reading: %2%.\n")) % file_name % ex);
-    return;
-  }
-
-  ebml_master_cptr m = analyzer->read_all(EBML_INFO(KaxTags));
+extract_tags(kax_analyzer_c &analyzer,
+             const std::string &output_file_name) {
+  ebml_master_cptr m = analyzer.read_all(EBML_INFO(KaxTags));
   if (!m)
     return;
 
   KaxTags *tags = dynamic_cast<KaxTags *>(m.get());
   assert(tags);
 
-  mtx::xml::ebml_tags_converter_c::write_xml(*tags, *g_mm_stdio);
+  mtx::xml::ebml_tags_converter_c::write_xml(*tags, *open_output_file(output_file_name));
 }
@@ -75,7 +75,7 @@ static std::vector<timecode_extractor_t> timecode_extractors;
 
 // ------------------------------------------------------------------------
 
-static void
+void
 close_timecode_files() {
   for (auto &extractor : timecode_extractors) {
     auto &timecodes = extractor.m_timecodes;
@@ -93,7 +93,7 @@ close_timecode_files() {
   timecode_extractors.clear();
 }
 
-static void
+void
 create_timecode_files(KaxTracks &kax_tracks,
                       std::vector<track_spec_t> &tracks,
                       int version) {
@@ -128,17 +128,16 @@ create_timecode_files(KaxTracks &kax_tracks,
   }
 }
 
-static
-std::vector<timecode_extractor_t>::iterator
+static std::vector<timecode_extractor_t>::iterator
 find_extractor_by_track_number(unsigned int track_number) {
   return std::find_if(timecode_extractors.begin(), timecode_extractors.end(),
                       [=](timecode_extractor_t &xtr) { return track_number == xtr.m_tnum; });
 }
 
-static void
-handle_blockgroup(KaxBlockGroup &blockgroup,
-                  KaxCluster &cluster,
-                  int64_t tc_scale) {
+void
+handle_timecodes_blockgroup(KaxBlockGroup &blockgroup,
+                            KaxCluster &cluster,
+                            int64_t tc_scale) {
   // Only continue if this block group actually contains a block.
   KaxBlock *block = FindChild<KaxBlock>(&blockgroup);
   if (!block)
@@ -160,9 +159,9 @@ handle_blockgroup(KaxBlockGroup &blockgroup,
     extractor->m_timecodes.push_back(timecode_t(block->GlobalTimecode() + i * duration / block->NumberFrames(), duration / block->NumberFrames()));
 }
 
-static void
-handle_simpleblock(KaxSimpleBlock &simpleblock,
-                   KaxCluster &cluster) {
+void
+handle_timecodes_simpleblock(KaxSimpleBlock &simpleblock,
+                             KaxCluster &cluster) {
   if (0 == simpleblock.NumberFrames())
     return;
 
@@ -177,211 +176,3 @@ handle_simpleblock(KaxSimpleBlock &simpleblock,
   for (i = 0; simpleblock.NumberFrames() > i; ++i)
     extractor->m_timecodes.push_back(timecode_t(simpleblock.GlobalTimecode() + i * extractor->m_default_duration, extractor->m_default_duration));
 }
-
-void
-extract_timecodes(const std::string &file_name,
-                  std::vector<track_spec_t> &tspecs,
-                  int version) {
-  if (tspecs.empty())
-    mxerror(Y("Nothing to do.\n"));
-
-  // open input file
-  mm_io_c *in;
-  try {
-    in = new mm_file_io_c(file_name, MODE_READ);
-  } catch (mtx::mm_io::exception &ex) {
-    show_error(boost::format(Y("The file '%1%' could not be opened for reading: %2%.\n")) % file_name % ex);
-    return;
-  }
-
-  try {
-    int64_t file_size = in->get_size();
-    EbmlStream *es    = new EbmlStream(*in);
-
-    // Find the EbmlHead element. Must be the first one.
-    EbmlElement *l0 = es->FindNextID(EBML_INFO(EbmlHead), 0xFFFFFFFFL);
-    if (!l0) {
-      show_error(Y("Error: No EBML head found."));
-      delete es;
-
-      return;
-    }
-
-    // Don't verify its data for now.
-    l0->SkipData(*es, EBML_CONTEXT(l0));
-    delete l0;
-
-    while (1) {
-      // Next element must be a segment
-      l0 = es->FindNextID(EBML_INFO(KaxSegment), 0xFFFFFFFFFFFFFFFFLL);
-      if (!l0) {
-        show_error(Y("No segment/level 0 element found."));
-        return;
-      }
-      if (Is<KaxSegment>(l0)) {
-        show_element(l0, 0, Y("Segment"));
-        break;
-      }
-
-      l0->SkipData(*es, EBML_CONTEXT(l0));
-      delete l0;
-    }
-
-    bool tracks_found = false;
-    int upper_lvl_el  = 0;
-    uint64_t tc_scale = TIMECODE_SCALE;
-
-    // We've got our segment, so let's find the tracks
-    EbmlElement *l1   = es->FindNextElement(EBML_CONTEXT(l0), upper_lvl_el, 0xFFFFFFFFL, true, 1);
-    EbmlElement *l2   = nullptr;
-    EbmlElement *l3   = nullptr;
-
-    while (l1 && (0 >= upper_lvl_el)) {
-      if (Is<KaxInfo>(l1)) {
-        // General info about this Matroska file
-        show_element(l1, 1, Y("Segment information"));
-
-        upper_lvl_el = 0;
-        l2           = es->FindNextElement(EBML_CONTEXT(l1), upper_lvl_el, 0xFFFFFFFFL, true, 1);
-        while (l2 && (0 >= upper_lvl_el)) {
-          if (Is<KaxTimecodeScale>(l2)) {
-            KaxTimecodeScale &ktc_scale = *static_cast<KaxTimecodeScale *>(l2);
-            ktc_scale.ReadData(es->I_O());
-            tc_scale = ktc_scale.GetValue();
-            show_element(l2, 2, boost::format(Y("Timecode scale: %1%")) % tc_scale);
-          } else
-            l2->SkipData(*es, EBML_CONTEXT(l2));
-
-          if (!in_parent(l1)) {
-            delete l2;
-            break;
-          }
-
-          if (0 > upper_lvl_el) {
-            upper_lvl_el++;
-            if (0 > upper_lvl_el)
-              break;
-
-          }
-
-          l2->SkipData(*es, EBML_CONTEXT(l2));
-          delete l2;
-          l2 = es->FindNextElement(EBML_CONTEXT(l1), upper_lvl_el, 0xFFFFFFFFL, true);
-        }
-
-      } else if ((Is<KaxTracks>(l1)) && !tracks_found) {
-
-        // Yep, we've found our KaxTracks element. Now find all tracks
-        // contained in this segment.
-        show_element(l1, 1, Y("Segment tracks"));
-
-        tracks_found = true;
-        l1->Read(*es, EBML_CLASS_CONTEXT(KaxTracks), upper_lvl_el, l2, true);
-        find_and_verify_track_uids(*dynamic_cast<KaxTracks *>(l1), tspecs);
-        create_timecode_files(*dynamic_cast<KaxTracks *>(l1), tspecs, version);
-
-      } else if (Is<KaxCluster>(l1)) {
-        show_element(l1, 1, Y("Cluster"));
-        KaxCluster *cluster = (KaxCluster *)l1;
-        uint64_t cluster_tc = 0;
-
-        if (0 == verbose)
-          mxinfo(boost::format(Y("Progress: %1%%%%2%")) % (int)(in->getFilePointer() * 100 / file_size) % "\r");
-
-        upper_lvl_el = 0;
-        l2           = es->FindNextElement(EBML_CONTEXT(l1), upper_lvl_el, 0xFFFFFFFFL, true, 1);
-        while (l2 && (0 >= upper_lvl_el)) {
-
-          if (Is<KaxClusterTimecode>(l2)) {
-            KaxClusterTimecode &ctc = *static_cast<KaxClusterTimecode *>(l2);
-            ctc.ReadData(es->I_O());
-            cluster_tc = ctc.GetValue();
-            show_element(l2, 2, boost::format(Y("Cluster timecode: %|1$.3f|s")) % ((float)cluster_tc * (float)tc_scale / 1000000000.0));
-            cluster->InitTimecode(cluster_tc, tc_scale);
-
-          } else if (Is<KaxBlockGroup>(l2)) {
-            show_element(l2, 2, Y("Block group"));
-
-            l2->Read(*es, EBML_CLASS_CONTEXT(KaxBlockGroup), upper_lvl_el, l3, true);
-            handle_blockgroup(*static_cast<KaxBlockGroup *>(l2), *cluster, tc_scale);
-
-          } else if (Is<KaxSimpleBlock>(l2)) {
-            show_element(l2, 2, Y("Simple block"));
-
-            l2->Read(*es, EBML_CLASS_CONTEXT(KaxSimpleBlock), upper_lvl_el, l3, true);
-            handle_simpleblock(*static_cast<KaxSimpleBlock *>(l2), *cluster);
-
-          } else
-            l2->SkipData(*es, EBML_CONTEXT(l2));
-
-          if (!in_parent(l1)) {
-            delete l2;
-            break;
-          }
-
-          if (0 < upper_lvl_el) {
-            upper_lvl_el--;
-            if (0 < upper_lvl_el)
-              break;
-            delete l2;
-            l2 = l3;
-            continue;
-
-          } else if (0 > upper_lvl_el) {
-            upper_lvl_el++;
-            if (0 > upper_lvl_el)
-              break;
-
-          }
-
-          l2->SkipData(*es, EBML_CONTEXT(l2));
-          delete l2;
-          l2 = es->FindNextElement(EBML_CONTEXT(l1), upper_lvl_el, 0xFFFFFFFFL, true);
-
-        } // while (l2)
-
-      } else
-        l1->SkipData(*es, EBML_CONTEXT(l1));
-
-      if (!in_parent(l0)) {
-        delete l1;
-        break;
-      }
-
-      if (0 < upper_lvl_el) {
-        upper_lvl_el--;
-        if (0 < upper_lvl_el)
-          break;
-        delete l1;
-        l1 = l2;
-        continue;
-
-      } else if (0 > upper_lvl_el) {
-        upper_lvl_el++;
-        if (0 > upper_lvl_el)
-          break;
-
-      }
-
-      l1->SkipData(*es, EBML_CONTEXT(l1));
-      delete l1;
-      l1 = es->FindNextElement(EBML_CONTEXT(l0), upper_lvl_el, 0xFFFFFFFFL, true);
-
-    } // while (l1)
-
-    delete l0;
-    delete es;
-    delete in;
-
-    close_timecode_files();
-
-    if (0 == verbose)
-      mxinfo(Y("Progress: 100%\n"));
-
-  } catch (...) {
-    show_error(Y("Caught exception"));
-    delete in;
-
-    close_timecode_files();
-  }
-}
@@ -13,6 +13,8 @@
 #include "common/common_pch.h"
 
 #include <cassert>
+#include <thread>
+#include <unordered_map>
 
 #include <ebml/EbmlHead.h>
 #include <ebml/EbmlSubHead.h>
@@ -32,19 +34,134 @@
 #include <matroska/KaxTrackAudio.h>
 #include <matroska/KaxTrackVideo.h>
 
+#include "common/debugging.h"
 #include "common/ebml.h"
 #include "common/kax_file.h"
 #include "common/mm_io_x.h"
 #include "common/mm_write_buffer_io.h"
 #include "extract/mkvextract.h"
 #include "extract/xtr_base.h"
+#include "extract/xtr_worker.h"
 
 using namespace libmatroska;
 
 static std::vector<xtr_base_c *> extractors;
+static std::unordered_map<xtr_base_c *, xtr_worker_cptr> extractor_workers;
+
+// Maximum amount of frame data waiting to be written per output file.
+static size_t const s_max_queued_bytes_per_worker = 32 * 1024 * 1024;
 
 // ------------------------------------------------------------------------
 
+static void
+abort_workers() {
+  for (auto &worker : extractor_workers)
+    worker.second->abort();
+
+  extractor_workers.clear();
+}
+
+// Extractors report fatal errors with mxerror(). Worker threads must not
+// exit the process themselves: the error is handed to the main thread
+// which stops all workers before exiting.
+static void
+install_worker_error_handler() {
+  auto main_thread_id = std::this_thread::get_id();
+
+  set_mxmsg_handler(MXMSG_ERROR, [main_thread_id](unsigned int level, std::string const &error) {
+    if (std::this_thread::get_id() != main_thread_id)
+      throw mtx::extract::worker_error_x{error};
+
+    abort_workers();
+    mxmsg(level, error);
+    mxexit(2);
+  });
+}
+
+static void
+create_workers() {
+  // Decoding and writing happens in one thread per output file. This
+  // only pays off if there's more than one output file.
+  auto num_files = std::count_if(extractors.begin(), extractors.end(), [](xtr_base_c *extractor) { return !extractor->m_master; });
+  if ((2 > num_files) || debugging_c::requested("extract_no_threads"))
+    return;
+
+  for (auto extractor : extractors)
+    if (!extractor->m_master)
+      extractor_workers[extractor] = std::make_shared<xtr_worker_c>(s_max_queued_bytes_per_worker);
+
+  for (auto extractor : extractors)
+    if (extractor->m_master)
+      extractor_workers[extractor] = extractor_workers[extractor->m_master];
+
+  install_worker_error_handler();
+}
+
+static void
+finish_workers() {
+  try {
+    for (auto &worker : extractor_workers)
+      worker.second->finish();
+
+  } catch (mtx::extract::worker_error_x &ex) {
+    mxerror(ex.what());
+  }
+
+  extractor_workers.clear();
+}
+
+static void
+queue_or_handle_frame(xtr_base_c *extractor,
+                      xtr_frame_t &f) {
+  auto worker = extractor_workers.find(extractor);
+  if (extractor_workers.end() == worker) {
+    extractor->decode_and_handle_frame(f);
+    return;
+  }
+
+  // The frame data and the block additions are owned by the block
+  // which will be freed before the worker gets around to processing
+  // them. Therefore copies have to be made.
+  xtr_queued_frame_t entry;
+  entry.m_extractor        = extractor;
+  entry.m_frame            = f.frame->clone();
+  entry.m_additions        = std::shared_ptr<KaxBlockAdditions>{f.additions ? static_cast<KaxBlockAdditions *>(f.additions->Clone()) : nullptr};
+  entry.m_timecode         = f.timecode;
+  entry.m_duration         = f.duration;
+  entry.m_bref             = f.bref;
+  entry.m_fref             = f.fref;
+  entry.m_keyframe         = f.keyframe;
+  entry.m_discardable      = f.discardable;
+  entry.m_references_valid = f.references_valid;
+  entry.m_discard_duration = f.discard_duration;
+
+  try {
+    worker->second->add(std::move(entry));
+  } catch (mtx::extract::worker_error_x &ex) {
+    mxerror(ex.what());
+  }
+}
+
+static void
+queue_or_handle_codec_state(xtr_base_c *extractor,
+                            memory_cptr &codec_state) {
+  auto worker = extractor_workers.find(extractor);
+  if (extractor_workers.end() == worker) {
+    extractor->handle_codec_state(codec_state);
+    return;
+  }
+
+  xtr_queued_frame_t entry;
+  entry.m_extractor   = extractor;
+  entry.m_codec_state = codec_state->clone();
+
+  try {
+    worker->second->add(std::move(entry));
+  } catch (mtx::extract::worker_error_x &ex) {
+    mxerror(ex.what());
+  }
+}
+
 static void
 create_extractors(KaxTracks &kax_tracks,
                   std::vector<track_spec_t> &tracks) {
@@ -118,6 +235,8 @@ create_extractors(KaxTracks &kax_tracks,
   // Signal that all headers have been taken care of.
   for (i = 0; i < extractors.size(); i++)
     extractors[i]->headers_done();
+
+  create_workers();
 }
 
 static int64_t
@@ -168,7 +287,7 @@ handle_blockgroup(KaxBlockGroup &blockgroup,
   KaxCodecState *kcstate = FindChild<KaxCodecState>(&blockgroup);
   if (kcstate) {
     memory_cptr codec_state(new memory_c(kcstate->GetBuffer(), kcstate->GetSize(), false));
-    extractor->handle_codec_state(codec_state);
+    queue_or_handle_codec_state(extractor, codec_state);
   }
 
   for (i = 0; i < block->NumberFrames(); i++) {
@@ -191,7 +310,7 @@ handle_blockgroup(KaxBlockGroup &blockgroup,
     auto &data = block->GetBuffer(i);
     auto frame = std::make_shared<memory_c>(data.Buffer(), data.Size(), false);
     auto f     = xtr_frame_t{frame, kadditions, this_timecode, this_duration, bref, fref, false, false, true, discard_padding};
-    extractor->decode_and_handle_frame(f);
+    queue_or_handle_frame(extractor, f);
 
     max_timecode = std::max(max_timecode, this_timecode);
   }
@@ -236,7 +355,7 @@ handle_simpleblock(KaxSimpleBlock &simpleblock,
     auto &data = simpleblock.GetBuffer(i);
     auto frame = std::make_shared<memory_c>(data.Buffer(), data.Size(), false);
     auto f     = xtr_frame_t{frame, nullptr, this_timecode, this_duration, -1, -1, simpleblock.IsKeyframe(), simpleblock.IsDiscardable(), false, timecode_c::ns(0)};
-    extractor->decode_and_handle_frame(f);
+    queue_or_handle_frame(extractor, f);
 
     max_timecode = std::max(max_timecode, this_timecode);
   }
@@ -248,6 +367,8 @@ static void
 close_extractors() {
   size_t i;
 
+  finish_workers();
+
   for (i = 0; i < extractors.size(); i++)
     extractors[i]->finish_track();
 
@@ -341,31 +462,35 @@ handle_segment_info(EbmlMaster *info,
   file->set_timecode_scale(tc_scale);
 }
 
+static void
+handle_tracks(KaxTracks &tracks,
+              std::vector<track_spec_t> &tspecs,
+              std::vector<track_spec_t> &timecode_tspecs) {
+  if (!tspecs.empty()) {
+    find_and_verify_track_uids(tracks, tspecs);
+    create_extractors(tracks, tspecs);
+  }
+
+  if (!timecode_tspecs.empty()) {
+    find_and_verify_track_uids(tracks, timecode_tspecs);
+    create_timecode_files(tracks, timecode_tspecs, 2);
+  }
+}
+
 bool
-extract_tracks(const std::string &file_name,
+extract_tracks(mm_io_cptr &in,
+               kax_analyzer_c *analyzer,
                std::vector<track_spec_t> &tspecs,
-               kax_analyzer_c::parse_mode_e parse_mode) {
-  if (tspecs.empty())
+               std::vector<track_spec_t> &timecode_tspecs) {
+  if (tspecs.empty() && timecode_tspecs.empty())
     mxerror(Y("Nothing to do.\n"));
 
-  // open input file
-  mm_io_cptr in;
-  kax_file_cptr file;
-  try {
-    in   = mm_file_io_c::open(file_name);
-    file = kax_file_cptr(new kax_file_c(in));
-  } catch (mtx::mm_io::exception &ex) {
-    show_error(boost::format(Y("The file '%1%' could not be opened for reading: %2%.\n")) % file_name % ex);
-    return false;
-  }
-
+  auto file         = kax_file_cptr(new kax_file_c(in));
   int64_t file_size = in->get_size();
   uint64_t tc_scale = TIMECODE_SCALE;
   bool segment_info_found = false, tracks_found = false;
 
-  // open input file
-  auto analyzer = std::make_shared<kax_analyzer_c>(static_cast<mm_file_io_c *>(in.get()));
-  if (analyzer->process(parse_mode, MODE_READ)) {
+  if (analyzer) {
     auto af_master    = ebml_master_cptr{ analyzer->read_all(EBML_INFO(KaxInfo)) };
     auto segment_info = dynamic_cast<KaxInfo *>(af_master.get());
     if (segment_info) {
@@ -377,8 +502,7 @@ extract_tracks(const std::string &file_name,
     auto tracks = dynamic_cast<KaxTracks *>(af_master.get());
     if (tracks) {
       tracks_found = true;
-      find_and_verify_track_uids(*tracks, tspecs);
-      create_extractors(*tracks, tspecs);
+      handle_tracks(*tracks, tspecs, timecode_tspecs);
     }
   }
 
@@ -429,8 +553,7 @@ extract_tracks(const std::string &file_name,
 
       } else if (Is<KaxTracks>(l1) && !tracks_found) {
         tracks_found = true;
-        find_and_verify_track_uids(*dynamic_cast<KaxTracks *>(l1), tspecs);
-        create_extractors(*dynamic_cast<KaxTracks *>(l1), tspecs);
+        handle_tracks(*static_cast<KaxTracks *>(l1), tspecs, timecode_tspecs);
 
       } else if (Is<KaxCluster>(l1)) {
         show_element(l1, 1, Y("Cluster"));
@@ -457,10 +580,12 @@ extract_tracks(const std::string &file_name,
           if (Is<KaxBlockGroup>(el)) {
             show_element(el, 2, Y("Block group"));
             max_bg_timecode = handle_blockgroup(*static_cast<KaxBlockGroup *>(el), *cluster, tc_scale);
+            handle_timecodes_blockgroup(*static_cast<KaxBlockGroup *>(el), *cluster, tc_scale);
 
           } else if (Is<KaxSimpleBlock>(el)) {
             show_element(el, 2, Y("SimpleBlock"));
             max_bg_timecode = handle_simpleblock(*static_cast<KaxSimpleBlock *>(el), *cluster);
+            handle_timecodes_simpleblock(*static_cast<KaxSimpleBlock *>(el), *cluster);
           }
 
           max_timecode = std::max(max_timecode, max_bg_timecode);
@@ -507,9 +632,12 @@ extract_tracks(const std::string &file_name,
     // lullaby. Just close your eyes, listen to her sweet voice, singing,
     // singing, fading... fad... ing...
     close_extractors();
+    close_timecode_files();
 
     return true;
   } catch (...) {
+    abort_workers();
+    close_timecode_files();
     show_error(Y("Caught exception"));
 
     return false;
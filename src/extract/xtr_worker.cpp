@@ -0,0 +1,160 @@
+/*
+   mkvextract -- extract tracks from Matroska files into other files
+
+   Distributed under the GPL
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   worker threads decoding and writing frames for extractors
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include "extract/xtr_worker.h"
+
+xtr_queued_frame_t::xtr_queued_frame_t()
+  : m_extractor{}
+  , m_timecode{}
+  , m_duration{}
+  , m_bref{}
+  , m_fref{}
+  , m_keyframe{}
+  , m_discardable{}
+  , m_references_valid{}
+{
+}
+
+xtr_worker_c::xtr_worker_c(size_t max_queued_bytes)
+  : m_queued_bytes{}
+  , m_max_queued_bytes{max_queued_bytes}
+  , m_finishing{}
+{
+  m_thread = std::thread{&xtr_worker_c::run, this};
+}
+
+xtr_worker_c::~xtr_worker_c() {
+  try {
+    finish();
+  } catch (...) {
+  }
+}
+
+void
+xtr_worker_c::add(xtr_queued_frame_t &&entry) {
+  auto size = (entry.m_frame ? entry.m_frame->get_size() : 0) + (entry.m_codec_state ? entry.m_codec_state->get_size() : 0);
+
+  {
+    std::unique_lock<std::mutex> lock{m_mutex};
+
+    // Always accept an entry if the queue is empty, even if it is
+    // larger than the limit all by itself.
+    m_space_available.wait(lock, [this, size]() { return m_exception || m_queue.empty() || ((m_queued_bytes + size) <= m_max_queued_bytes); });
+
+    if (!m_exception) {
+      m_queue.push_back(std::move(entry));
+      m_queued_bytes += size;
+    }
+  }
+
+  m_entries_available.notify_one();
+
+  rethrow_exception_maybe();
+}
+
+void
+xtr_worker_c::finish() {
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_finishing = true;
+  }
+
+  m_entries_available.notify_one();
+
+  if (m_thread.joinable())
+    m_thread.join();
+
+  rethrow_exception_maybe();
+}
+
+// Stops the thread as soon as the current entry has been processed,
+// dropping all remaining entries and errors.
+void
+xtr_worker_c::abort() {
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_finishing    = true;
+    m_queued_bytes = 0;
+    m_queue.clear();
+  }
+
+  m_entries_available.notify_one();
+
+  if (m_thread.joinable())
+    m_thread.join();
+
+  std::lock_guard<std::mutex> lock{m_mutex};
+  m_exception = std::exception_ptr{};
+}
+
+void
+xtr_worker_c::rethrow_exception_maybe() {
+  std::exception_ptr exception;
+
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    std::swap(exception, m_exception);
+  }
+
+  if (exception)
+    std::rethrow_exception(exception);
+}
+
+void
+xtr_worker_c::run() {
+  while (true) {
+    xtr_queued_frame_t entry;
+
+    {
+      std::unique_lock<std::mutex> lock{m_mutex};
+      m_entries_available.wait(lock, [this]() { return m_finishing || !m_queue.empty(); });
+
+      if (m_queue.empty())
+        return;
+
+      entry = std::move(m_queue.front());
+      m_queue.pop_front();
+    }
+
+    try {
+      process(entry);
+
+    } catch (...) {
+      std::lock_guard<std::mutex> lock{m_mutex};
+      m_exception = std::current_exception();
+      m_queue.clear();
+      m_queued_bytes = 0;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock{m_mutex};
+      m_queued_bytes -= std::min<size_t>(m_queued_bytes, (entry.m_frame ? entry.m_frame->get_size() : 0) + (entry.m_codec_state ? entry.m_codec_state->get_size() : 0));
+    }
+
+    m_space_available.notify_one();
+  }
+}
+
+void
+xtr_worker_c::process(xtr_queued_frame_t &entry) {
+  if (entry.m_codec_state)
+    entry.m_extractor->handle_codec_state(entry.m_codec_state);
+
+  if (!entry.m_frame)
+    return;
+
+  auto f = xtr_frame_t{entry.m_frame, entry.m_additions.get(), entry.m_timecode, entry.m_duration, entry.m_bref, entry.m_fref,
+                       entry.m_keyframe, entry.m_discardable, entry.m_references_valid, entry.m_discard_duration};
+  entry.m_extractor->decode_and_handle_frame(f);
+}
@@ -0,0 +1,96 @@
+/*
+   mkvextract -- extract tracks from Matroska files into other files
+
+   Distributed under the GPL
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   worker threads decoding and writing frames for extractors
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_EXTRACT_XTR_WORKER_H
+#define MTX_EXTRACT_XTR_WORKER_H
+
+#include "common/common_pch.h"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "common/error.h"
+#include "extract/xtr_base.h"
+
+namespace mtx { namespace extract {
+
+// Thrown instead of exiting when mxerror() is called from a worker
+// thread. The main thread re-issues the error once it has picked it up.
+class worker_error_x: public exception {
+protected:
+  std::string m_message;
+
+public:
+  worker_error_x(std::string const &message)
+    : m_message{message}
+  {
+  }
+  virtual ~worker_error_x() throw() { }
+
+  virtual const char *what() const throw() {
+    return m_message.c_str();
+  }
+};
+
+}}
+
+// A frame or a codec state that has been read from the file but not
+// handed to its extractor yet. All data is owned by the entry as the
+// blocks it was read from are freed as soon as their cluster has been
+// processed.
+struct xtr_queued_frame_t {
+  xtr_base_c *m_extractor;
+  memory_cptr m_frame, m_codec_state;
+  std::shared_ptr<KaxBlockAdditions> m_additions;
+  int64_t m_timecode, m_duration, m_bref, m_fref;
+  bool m_keyframe, m_discardable, m_references_valid;
+  timecode_c m_discard_duration;
+
+  xtr_queued_frame_t();
+};
+
+// Each worker serves all extractors writing to the same output file
+// (a master and its slaves). Entries are processed in the order they
+// have been queued, so the output is identical to processing them
+// directly in the demuxing loop. Memory usage is bounded: queueing
+// blocks while the entries waiting in the queue exceed a given size.
+class xtr_worker_c {
+protected:
+  std::deque<xtr_queued_frame_t> m_queue;
+  size_t m_queued_bytes, m_max_queued_bytes;
+  bool m_finishing;
+  std::exception_ptr m_exception;
+
+  std::mutex m_mutex;
+  std::condition_variable m_entries_available, m_space_available;
+  std::thread m_thread;
+
+public:
+  xtr_worker_c(size_t max_queued_bytes);
+  virtual ~xtr_worker_c();
+
+  void add(xtr_queued_frame_t &&entry);
+  void finish();
+  void abort();
+
+protected:
+  void run();
+  void rethrow_exception_maybe();
+
+  static void process(xtr_queued_frame_t &entry);
+};
+typedef std::shared_ptr<xtr_worker_c> xtr_worker_cptr;
+
+#endif // MTX_EXTRACT_XTR_WORKER_H
@@ -48,6 +48,12 @@ ui_show_error(const std::string &error) {
   console_show_error(error);
 }
 
+void
+ui_show_deferred_cluster(int64_t position,
+                         int64_t size) {
+  console_show_element(1, Y("Cluster"), position, size);
+}
+
 void
 ui_show_progress(int /* percentage */,
                  const std::string &/* text */) {
@@ -1603,6 +1603,40 @@ display_track_info() {
   }
 }
 
+/** \brief Show a cluster without reading its content
+
+   Only the cluster's ID and size are read. The GUI parses its
+   children later via \c process_cluster when the user expands the
+   cluster. Returns \c false and resets the file position if the next
+   element is not a cluster of known size.
+*/
+static bool
+show_deferred_cluster(mm_io_cptr &in,
+                      int64_t file_size) {
+  auto position = static_cast<int64_t>(in->getFilePointer());
+
+  try {
+    auto id = vint_c::read_ebml_id(in);
+    if (id.is_valid() && (EBML_ID_VALUE(EBML_ID(KaxCluster)) == id.m_value)) {
+      auto size       = vint_c::read(in);
+      auto total_size = static_cast<int64_t>(in->getFilePointer()) - position + size.m_value;
+
+      if (size.is_valid() && !size.is_unknown() && ((position + total_size) <= file_size)) {
+        ui_show_progress(100 * position / file_size, Y("Parsing file"));
+        ui_show_deferred_cluster(position, total_size);
+        in->setFilePointer(position + total_size, seek_beginning);
+
+        return true;
+      }
+    }
+  } catch (mtx::mm_io::exception &) {
+  }
+
+  in->setFilePointer(position, seek_beginning);
+
+  return false;
+}
+
 bool
 process_file(const std::string &file_name) {
   int upper_lvl_el;
@@ -1670,7 +1704,17 @@ process_file(const std::string &file_name) {
     // Prevent reporting "first timecode after resync":
     kax_file->set_timecode_scale(-1);
 
-    while ((l1 = kax_file->read_next_level1_element())) {
+    while (true) {
+      if (g_options.m_defer_cluster_parsing && (0 != g_options.m_verbose) && !g_options.m_show_summary && show_deferred_cluster(in, file_size)) {
+        if (!in_parent(l0))
+          break;
+        continue;
+      }
+
+      l1 = kax_file->read_next_level1_element();
+      if (!l1)
+        break;
+
       std::shared_ptr<EbmlElement> af_l1(l1);
 
       if (Is<KaxInfo>(l1))
@@ -1728,6 +1772,43 @@ process_file(const std::string &file_name) {
   }
 }
 
+bool
+process_cluster(const std::string &file_name,
+                int64_t position) {
+  mm_io_cptr in;
+  try {
+    in = mm_file_io_c::open(file_name);
+  } catch (mtx::mm_io::exception &ex) {
+    show_error((boost::format(Y("Error: Couldn't open input file %1% (%2%).\n")) % file_name % ex).str());
+    return false;
+  }
+
+  try {
+    auto file_size = static_cast<int64_t>(in->get_size());
+    auto es        = std::make_shared<EbmlStream>(*in);
+    auto kax_file  = std::make_shared<kax_file_c>(in);
+
+    kax_file->set_timecode_scale(-1);
+    in->setFilePointer(position, seek_beginning);
+
+    auto l1 = std::shared_ptr<EbmlElement>{kax_file->read_next_level1_element(EBML_ID_VALUE(EBML_ID(KaxCluster)))};
+    if (!l1 || !Is<KaxCluster>(l1.get()) || (static_cast<int64_t>(l1->GetElementPosition()) != position))
+      return false;
+
+    EbmlStream *es_ptr  = es.get();
+    EbmlElement *l1_ptr = l1.get();
+    int upper_lvl_el    = 0;
+
+    handle_cluster(es_ptr, upper_lvl_el, l1_ptr, file_size);
+
+    return true;
+
+  } catch (...) {
+    show_error(Y("Caught exception"));
+    return false;
+  }
+}
+
 void
 setup(char const *argv0,
       std::string const &locale) {
@@ -24,12 +24,14 @@ extern options_c g_options;
 
 int console_main();
 bool process_file(const std::string &file_name);
+bool process_cluster(const std::string &file_name, int64_t position);
 void setup(char const *argv0, const std::string &locale = "");
 void cleanup();
 
 std::string create_element_text(const std::string &text, int64_t position, int64_t size);
 void ui_show_error(const std::string &error);
 void ui_show_element(int level, const std::string &text, int64_t position, int64_t size);
+void ui_show_deferred_cluster(int64_t position, int64_t size);
 void ui_show_progress(int percentage, const std::string &text);
 int ui_run(int argc, char **argv);
 bool ui_graphical_available();
@@ -29,9 +29,50 @@
 using namespace libebml;
 using namespace libmatroska;
 
+parser_thread_c::parser_thread_c(const QString &file_name)
+  : QThread{}
+  , m_file_name{to_utf8(file_name)}
+  , m_ok{}
+{
+}
+
+bool
+parser_thread_c::is_ok()
+  const {
+  return m_ok;
+}
+
+void
+parser_thread_c::run() {
+  m_ok = process_file(m_file_name);
+}
+
+void
+parser_thread_c::add_item(int level,
+                          const QString &text) {
+  emit item_found(level, text);
+}
+
+void
+parser_thread_c::add_deferred_cluster(const QString &text,
+                                      qint64 position) {
+  emit deferred_cluster_found(text, position);
+}
+
+void
+parser_thread_c::report_error(const QString &message) {
+  emit error_found(message);
+}
+
+void
+parser_thread_c::report_progress(int percentage,
+                                 const QString &text) {
+  emit progress_changed(percentage, text);
+}
+
 main_window_c::main_window_c():
   last_percent(-1), num_elements(0),
-  root(nullptr) {
+  root(nullptr), parser_thread(nullptr) {
 
   setupUi(this);
 
@@ -44,6 +85,8 @@ main_window_c::main_window_c():
 
   connect(action_About, SIGNAL(triggered()), this, SLOT(about()));
 
+  connect(tree, SIGNAL(itemExpanded(QTreeWidgetItem *)), this, SLOT(item_expanded(QTreeWidgetItem *)));
+
   action_Save_text_file->setEnabled(false);
 
   action_Show_all->setCheckable(true);
@@ -59,6 +102,12 @@ main_window_c::main_window_c():
   root->setText(0, Q(Y("no file loaded")));
 }
 
+main_window_c::~main_window_c() {
+  if (parser_thread)
+    parser_thread->wait();
+  delete parser_thread;
+}
+
 void
 main_window_c::open() {
   QString file_name = QFileDialog::getOpenFileName(this, Q(Y("Open File")), "", Q(Y("Matroska files (*.mkv *.mka *.mks *.mk3d);;All files (*.*)")));
@@ -132,6 +181,9 @@ main_window_c::show_error(const QString &msg) {
 
 void
 main_window_c::parse_file(const QString &file_name) {
+  if (parser_thread && parser_thread->isRunning())
+    return;
+
   tree->setEnabled(false);
   tree->clear();
 
@@ -141,22 +193,63 @@ main_window_c::parse_file(const QString &file_name) {
   last_percent = -1;
   num_elements = 0;
   action_Save_text_file->setEnabled(false);
+  action_Open->setEnabled(false);
+  action_Show_all->setEnabled(false);
 
   parent_items.clear();
   parent_items.append(root);
 
-  if (process_file(file_name.toUtf8().data())) {
+  // The file is parsed in the background so that the window stays
+  // responsive. Clusters are only added as placeholders; their
+  // content is read when they're expanded (see item_expanded()).
+  parsed_file = file_name;
+
+  delete parser_thread;
+  parser_thread = new parser_thread_c(file_name);
+
+  connect(parser_thread, SIGNAL(item_found(int, const QString &)),               this, SLOT(add_item(int, const QString &)),               Qt::QueuedConnection);
+  connect(parser_thread, SIGNAL(deferred_cluster_found(const QString &, qint64)), this, SLOT(add_deferred_cluster(const QString &, qint64)), Qt::QueuedConnection);
+  connect(parser_thread, SIGNAL(error_found(const QString &)),                   this, SLOT(show_error(const QString &)),                  Qt::QueuedConnection);
+  connect(parser_thread, SIGNAL(progress_changed(int, const QString &)),          this, SLOT(show_progress(int, const QString &)),          Qt::QueuedConnection);
+  connect(parser_thread, SIGNAL(finished()),                                     this, SLOT(parsing_finished()),                           Qt::QueuedConnection);
+
+  parser_thread->start();
+}
+
+void
+main_window_c::parsing_finished() {
+  if (parser_thread->is_ok()) {
     action_Save_text_file->setEnabled(true);
-    current_file = file_name;
+    current_file = parsed_file;
     if (action_Expand_important->isChecked())
       expand_elements();
   }
 
   statusBar()->showMessage(Q(Y("Ready")), 5000);
 
+  action_Open->setEnabled(true);
+  action_Show_all->setEnabled(true);
   tree->setEnabled(true);
 }
 
+void
+main_window_c::item_expanded(QTreeWidgetItem *item) {
+  auto position = item->data(0, Qt::UserRole);
+  if (!position.isValid() || (0 != item->childCount()))
+    return;
+
+  item->setData(0, Qt::UserRole, QVariant{});
+  item->setChildIndicatorPolicy(QTreeWidgetItem::DontShowIndicatorWhenChildless);
+
+  // Cluster children are shown on level 2.
+  parent_items.clear();
+  parent_items << root << item->parent() << item;
+
+  process_cluster(to_utf8(current_file), position.toLongLong());
+
+  statusBar()->showMessage(Q(Y("Ready")), 5000);
+}
+
 void
 main_window_c::expand_all_elements(QTreeWidgetItem *item,
                                    bool expand) {
@@ -213,18 +306,34 @@ main_window_c::add_item(int level,
   parent_items.append(item);
 }
 
+void
+main_window_c::add_deferred_cluster(const QString &text,
+                                    qint64 position) {
+  add_item(1, text);
+
+  auto item = parent_items.last();
+  item->setData(0, Qt::UserRole, position);
+  item->setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
+}
+
 void
 main_window_c::show_progress(int percentage,
                              const QString &text) {
   if ((percentage / 5) != (last_percent / 5)) {
     statusBar()->showMessage(QString("%1: %2%").arg(text).arg(percentage));
     last_percent = percentage;
-    QCoreApplication::processEvents();
+    if (!parser_thread || !parser_thread->isRunning())
+      QCoreApplication::processEvents();
   }
 }
 
 static main_window_c *gui;
 
+static parser_thread_c *
+current_parser_thread() {
+  return dynamic_cast<parser_thread_c *>(QThread::currentThread());
+}
+
 rightclick_tree_widget::rightclick_tree_widget(QWidget *parent):
   QTreeWidget(parent) {
 }
@@ -248,10 +357,14 @@ rightclick_tree_widget::mousePressEvent(QMouseEvent *event) {
 
 void
 ui_show_error(const std::string &error) {
-  if (g_options.m_use_gui)
-    gui->show_error(Q(error.c_str()));
-  else
+  if (!g_options.m_use_gui)
     console_show_error(error);
+
+  else if (current_parser_thread())
+    current_parser_thread()->report_error(Q(error.c_str()));
+
+  else
+    gui->show_error(Q(error.c_str()));
 }
 
 void
@@ -259,20 +372,37 @@ ui_show_element(int level,
                 const std::string &text,
                 int64_t position,
                 int64_t size) {
-  if (!g_options.m_use_gui)
+  if (!g_options.m_use_gui) {
     console_show_element(level, text, position, size);
+    return;
+  }
+
+  auto item_text = Q((0 <= position ? create_element_text(text, position, size) : text).c_str());
+
+  if (current_parser_thread())
+    current_parser_thread()->add_item(level, item_text);
+  else
+    gui->add_item(level, item_text);
+}
 
-  else if (0 <= position)
-    gui->add_item(level, Q(create_element_text(text, position, size).c_str()));
+void
+ui_show_deferred_cluster(int64_t position,
+                         int64_t size) {
+  auto item_text = Q(create_element_text(Y("Cluster"), position, size).c_str());
 
+  if (current_parser_thread())
+    current_parser_thread()->add_deferred_cluster(item_text, position);
   else
-    gui->add_item(level, Q(text.c_str()));
+    gui->add_deferred_cluster(item_text, position);
 }
 
 void
 ui_show_progress(int percentage,
                  const std::string &text) {
-  gui->show_progress(percentage, Q(text.c_str()));
+  if (current_parser_thread())
+    current_parser_thread()->report_progress(percentage, Q(text.c_str()));
+  else
+    gui->show_progress(percentage, Q(text.c_str()));
 }
 
 int
@@ -283,6 +413,8 @@ ui_run(int argc,
   gui = &main_window;
   main_window.show();
 
+  g_options.m_defer_cluster_parsing = true;
+
   if (!g_options.m_file_name.empty())
     gui->parse_file(Q(g_options.m_file_name.c_str()));
 
@@ -18,11 +18,39 @@
 #include <QFile>
 #include <QMainWindow>
 #include <QString>
+#include <QThread>
 #include <QTreeWidgetItem>
 #include <QVector>
 
 #include "info/ui/mainwindow.h"
 
+class parser_thread_c: public QThread {
+  Q_OBJECT;
+
+private:
+  std::string m_file_name;
+  bool m_ok;
+
+public:
+  parser_thread_c(const QString &file_name);
+
+  bool is_ok() const;
+
+  void add_item(int level, const QString &text);
+  void add_deferred_cluster(const QString &text, qint64 position);
+  void report_error(const QString &message);
+  void report_progress(int percentage, const QString &text);
+
+protected:
+  virtual void run();
+
+signals:
+  void item_found(int level, const QString &text);
+  void deferred_cluster_found(const QString &text, qint64 position);
+  void error_found(const QString &message);
+  void progress_changed(int percentage, const QString &text);
+};
+
 class main_window_c: public QMainWindow, public Ui_main_window {
   Q_OBJECT;
 
@@ -34,23 +62,32 @@ private slots:
 
   void about();
 
+  void parsing_finished();
+  void item_expanded(QTreeWidgetItem *item);
+
 private:
   int last_percent, num_elements;
 
   QVector<QTreeWidgetItem *> parent_items;
-  QString current_file;
+  QString current_file, parsed_file;
   QTreeWidgetItem *root;
+  parser_thread_c *parser_thread;
 
   void expand_elements();
   void write_tree(QFile &file, QTreeWidgetItem *item, int level);
 
 public:
   main_window_c();
+  virtual ~main_window_c();
 
+public slots:
   void show_error(const QString &message);
   void show_progress(int percentage, const QString &text);
 
   void add_item(int level, const QString &text);
+  void add_deferred_cluster(const QString &text, qint64 position);
+
+public:
 
   void expand_all_elements(QTreeWidgetItem *item, bool expand);
 
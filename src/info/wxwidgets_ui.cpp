@@ -410,6 +410,12 @@ ui_show_element(int level,
     frame->add_item(level, wxU(text.c_str()));
 }
 
+void
+ui_show_deferred_cluster(int64_t position,
+                         int64_t size) {
+  ui_show_element(1, Y("Cluster"), position, size);
+}
+
 void
 ui_show_progress(int percentage,
                  const std::string &text) {
@@ -18,11 +18,12 @@
 
 #include "common/codec.h"
 #include "common/flac.h"
+#include "common/strings/formatting.h"
 #include "input/r_flac.h"
 #include "merge/output_control.h"
 #include "merge/pr_generic.h"
 
-#define BUFFER_SIZE 4096
+#define BUFFER_SIZE (64 * 1024)
 
 #if defined(HAVE_FLAC_FORMAT_H)
 
@@ -105,7 +106,12 @@ flac_reader_c::probe_file(mm_io_c *io,
 flac_reader_c::flac_reader_c(const track_info_c &ti,
                              const mm_io_cptr &in)
   : generic_reader_c(ti, in)
+  , m_chunk(memory_c::alloc(BUFFER_SIZE))
+  , m_file_done(false)
   , samples(0)
+  , m_header_size(0)
+  , m_max_frame_size(0)
+  , m_buffer(16 * BUFFER_SIZE)
 {
 }
 
@@ -116,24 +122,24 @@ flac_reader_c::read_headers() {
 
   show_demuxer_info();
 
-  if (!parse_file())
+  if (!parse_metadata())
     throw mtx::input::header_parsing_x();
 
-  try {
-    uint32_t block_size = 0;
-
-    for (current_block = blocks.begin(); (current_block != blocks.end()) && (FLAC_BLOCK_TYPE_HEADERS == current_block->type); current_block++)
-      block_size += current_block->len;
+  // A damaged frame's CRC never matches. The search for its end must be
+  // bounded by the size valid frames can have at most.
+  if (stream_info.max_framesize)
+    m_max_frame_size = stream_info.max_framesize;
+  else {
+    auto max_block_size = stream_info.max_blocksize ? stream_info.max_blocksize : 65535u;
+    m_max_frame_size    = static_cast<size_t>(max_block_size) * stream_info.channels * (stream_info.bits_per_sample + 1) / 8 + 1024;
+  }
 
-    m_header = memory_c::alloc(block_size);
+  try {
+    m_header = memory_c::alloc(m_header_size);
 
-    block_size         = 0;
-    for (current_block = blocks.begin(); (current_block != blocks.end()) && (FLAC_BLOCK_TYPE_HEADERS == current_block->type); current_block++) {
-      m_in->setFilePointer(current_block->filepos);
-      if (m_in->read(m_header->get_buffer() + block_size, current_block->len) != current_block->len)
-        mxerror(Y("flac_reader: Could not read a header packet.\n"));
-      block_size += current_block->len;
-    }
+    m_in->setFilePointer(4);
+    if (m_in->read(m_header->get_buffer(), m_header_size) != m_header_size)
+      mxerror(Y("flac_reader: Could not read a header packet.\n"));
 
   } catch (mtx::exception &) {
     mxerror(Y("flac_reader: could not initialize the FLAC packetizer.\n"));
@@ -152,19 +158,20 @@ flac_reader_c::create_packetizer(int64_t) {
   show_packetizer_info(0, PTZR0);
 }
 
+/** \brief Parse the metadata blocks only
+
+   The frames themselves are located while muxing by \c read(), so
+   there's no need for a separate pass over the whole file.
+*/
 bool
-flac_reader_c::parse_file() {
+flac_reader_c::parse_metadata() {
   FLAC__StreamDecoder *decoder;
-  FLAC__StreamDecoderState state;
-  flac_block_t block;
-  uint64_t u, old_pos;
-  int result, progress, old_progress;
-  bool ok;
+  uint64_t u = 0;
+  int result;
 
   m_in->setFilePointer(0);
   metadata_parsed = false;
 
-  mxinfo(Y("+-> Parsing the FLAC file. This can take a LONG time.\n"));
   decoder = FLAC__stream_decoder_new();
   if (!decoder)
     mxerror(Y("flac_reader: FLAC__stream_decoder_new() failed.\n"));
@@ -176,85 +183,115 @@ flac_reader_c::parse_file() {
 
   result = FLAC__stream_decoder_process_until_end_of_metadata(decoder);
 
-  mxverb(2, boost::format("flac_reader: extract->metadata, result: %1%, mdp: %2%, num blocks: %3%\n") % result % metadata_parsed % blocks.size());
+  mxverb(2, boost::format("flac_reader: extract->metadata, result: %1%, mdp: %2%\n") % result % metadata_parsed);
 
   if (!metadata_parsed)
     mxerror_fn(m_ti.m_fname, Y("No metadata block found. This file is broken.\n"));
 
   FLAC__stream_decoder_get_decode_position(decoder, &u);
 
-  block.type    = FLAC_BLOCK_TYPE_HEADERS;
-  block.filepos = 0;
-  block.len     = u;
-  old_pos       = u;
+  FLAC__stream_decoder_reset(decoder);
+  FLAC__stream_decoder_delete(decoder);
 
-  blocks.push_back(block);
+  if (4 >= u)
+    mxerror(Y("flac_reader: Could not read all header packets.\n"));
 
-  mxverb(2, boost::format("flac_reader: headers: block at %1% with size %2%\n") % block.filepos % block.len);
+  m_header_size = u - 4;
 
-  old_progress = -5;
-  ok = FLAC__stream_decoder_skip_single_frame(decoder);
-  while (ok) {
-    state = FLAC__stream_decoder_get_state(decoder);
+  mxverb(2, boost::format("flac_reader: headers: block at 4 with size %1%\n") % m_header_size);
 
-    progress = m_in->getFilePointer() * 100 / m_size;
-    if ((progress - old_progress) >= 5) {
-      mxinfo(boost::format(Y("+-> Pre-parsing FLAC file: %1%%%%2%")) % progress % "\r");
-      old_progress = progress;
-    }
+  return metadata_parsed;
+}
 
-    if (FLAC__stream_decoder_get_decode_position(decoder, &u) && (u != old_pos)) {
-      block.type    = FLAC_BLOCK_TYPE_DATA;
-      block.filepos = old_pos;
-      block.len     = u - old_pos;
-      old_pos       = u;
-      blocks.push_back(block);
+void
+flac_reader_c::fill_buffer() {
+  auto num_read = m_in->read(m_chunk->get_buffer(), m_chunk->get_size());
+  if (num_read)
+    m_buffer.add(m_chunk->get_buffer(), num_read);
 
-      mxverb(2, boost::format("flac_reader: skip/decode frame, block at %1% with size %2%\n") % block.filepos % block.len);
-    }
+  if (num_read < m_chunk->get_size())
+    m_file_done = true;
+}
 
-    if (state > FLAC__STREAM_DECODER_READ_FRAME)
-      break;
+/** \brief Find the next valid frame header in the buffer
 
-    ok = FLAC__stream_decoder_skip_single_frame(decoder);
+   More data is read from the file as needed. Headers are only
+   checked once they are complete unless the end of the file has been
+   reached.
+
+   \return The header's offset in the buffer or \c std::string::npos
+     if there is none left.
+*/
+size_t
+flac_reader_c::find_frame_header(size_t start) {
+  while (true) {
+    auto buf  = m_buffer.get_buffer();
+    auto size = m_buffer.get_size();
+    auto end  = m_file_done ? size : size - std::min<size_t>(size, FLAC_MAX_FRAME_HEADER_SIZE);
+
+    for (auto pos = start; pos < end; ++pos)
+      if ((0xff == buf[pos]) && flac_get_frame_header_size(&buf[pos], size - pos))
+        return pos;
+
+    if (m_file_done)
+      return std::string::npos;
+
+    start = std::max(start, end);
+    fill_buffer();
   }
+}
 
-  if (100 != old_progress)
-    mxinfo(Y("+-> Pre-parsing FLAC file: 100%\n"));
-  else
-    mxinfo("\n");
+/** \brief Determine the size of the frame at the start of the buffer
 
-  if ((blocks.size() == 0) || (blocks[0].type != FLAC_BLOCK_TYPE_HEADERS))
-    mxerror(Y("flac_reader: Could not read all header packets.\n"));
+   More data is read from the file until \c flac_find_frame_size() has
+   found the frame's end. Damaged frames are split at the next frame
+   header instead of swallowing the rest of the file.
+*/
+size_t
+flac_reader_c::find_frame_size() {
+  auto search = flac_frame_search_t{};
 
-  FLAC__stream_decoder_reset(decoder);
-  FLAC__stream_decoder_delete(decoder);
+  while (true) {
+    auto frame_size = flac_find_frame_size(m_buffer.get_buffer(), m_buffer.get_size(), m_max_frame_size, m_file_done, search);
 
-  m_in->setFilePointer(0);
-  blocks[0].len     -= 4;
-  blocks[0].filepos  = 4;
+    if (!frame_size) {
+      fill_buffer();
+      continue;
+    }
 
-  return metadata_parsed;
+    if (search.crc_mismatch)
+      mxwarn_fn(m_ti.m_fname,
+                boost::format(Y("The CRC of the frame at timecode %1% does not match. The frame is probably damaged and will be used as it is.\n"))
+                % format_timecode(samples * 1000000000 / sample_rate, 3));
+
+    return frame_size;
+  }
 }
 
 file_status_e
 flac_reader_c::read(generic_packetizer_c *,
                     bool) {
-  if (current_block == blocks.end())
+  auto frame_start = find_frame_header(0);
+  if (std::string::npos == frame_start) {
+    m_buffer.clear();
     return flush_packetizers();
+  }
 
-  memory_cptr buf = memory_c::alloc(current_block->len);
-  m_in->setFilePointer(current_block->filepos);
-  if (m_in->read(buf, current_block->len) != current_block->len)
-    return flush_packetizers();
+  if (frame_start) {
+    mxverb(2, boost::format("flac_reader: skipping %1% bytes before the next frame\n") % frame_start);
+    m_buffer.remove(frame_start);
+  }
+
+  auto frame_size = find_frame_size();
+  auto frame      = memory_c::clone(m_buffer.get_buffer(), frame_size);
+  m_buffer.remove(frame_size);
 
-  unsigned int samples_here = flac_get_num_samples(buf->get_buffer(), current_block->len, stream_info);
-  PTZR0->process(new packet_t(buf, samples * 1000000000 / sample_rate));
+  unsigned int samples_here = flac_get_num_samples(frame->get_buffer(), frame_size, stream_info);
+  PTZR0->process(new packet_t(frame, samples * 1000000000 / sample_rate));
 
   samples += samples_here;
-  current_block++;
 
-  return (current_block == blocks.end()) ? flush_packetizers() : FILE_STATUS_MOREDATA;
+  return FILE_STATUS_MOREDATA;
 }
 
 FLAC__StreamDecoderReadStatus
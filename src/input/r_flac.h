@@ -16,6 +16,7 @@
 
 #include "common/common_pch.h"
 
+#include "common/byte_buffer.h"
 #include "common/mm_io.h"
 #include "merge/pr_generic.h"
 
@@ -26,22 +27,14 @@
 
 #include "output/p_flac.h"
 
-#define FLAC_BLOCK_TYPE_HEADERS 0
-#define FLAC_BLOCK_TYPE_DATA    1
-
-typedef struct {
-  int64_t filepos;
-  unsigned int type, len;
-} flac_block_t;
-
 class flac_reader_c: public generic_reader_c {
 private:
-  memory_cptr m_header;
+  memory_cptr m_header, m_chunk;
   int sample_rate;
-  bool metadata_parsed;
-  uint64_t samples;
-  std::vector<flac_block_t> blocks;
-  std::vector<flac_block_t>::iterator current_block;
+  bool metadata_parsed, m_file_done;
+  uint64_t samples, m_header_size;
+  size_t m_max_frame_size;
+  byte_buffer_c m_buffer;
   FLAC__StreamMetadata_StreamInfo stream_info;
 
 public:
@@ -76,7 +69,10 @@ public:
   virtual FLAC__bool eof_cb();
 
 protected:
-  virtual bool parse_file();
+  virtual bool parse_metadata();
+  virtual void fill_buffer();
+  virtual size_t find_frame_header(size_t start);
+  virtual size_t find_frame_size();
 };
 
 #else  // HAVE_FLAC_FORMAT_H
@@ -111,15 +111,22 @@ flv_tag_c::is_script_data()
 bool
 flv_tag_c::read(mm_io_cptr const &in) {
   try {
+    // previous tag size (4), flags (1), data size (3), timecode (3),
+    // extended timecode (1), stream ID (3)
+    unsigned char buffer[15];
+
     auto position       = in->getFilePointer();
     m_ok                = false;
-    m_previous_tag_size = in->read_uint32_be();
-    m_flags             = in->read_uint8();
-    m_data_size         = in->read_uint24_be();
-    m_timecode          = in->read_uint24_be();
-    m_timecode_extended = in->read_uint8();
-    in->skip(3);
-    m_next_position     = in->getFilePointer() + m_data_size;
+
+    if (in->read(buffer, 15) != 15)
+      return false;
+
+    m_previous_tag_size = get_uint32_be(&buffer[0]);
+    m_flags             = buffer[4];
+    m_data_size         = get_uint24_be(&buffer[5]);
+    m_timecode          = get_uint24_be(&buffer[8]);
+    m_timecode_extended = buffer[11];
+    m_next_position     = position + 15 + m_data_size;
     m_ok                = true;
 
     mxdebug_if(m_debug, boost::format("Tag @ %1%: %2%\n") % position % *this);
@@ -254,6 +261,7 @@ flv_reader_c::flv_reader_c(track_info_c const &ti,
   , m_selected_track_idx{-1}
   , m_file_done{false}
   , m_debug{"flv|flv_full"}
+  , m_debug_stats{"flv_full|flv_stats"}
 {
 }
 
@@ -320,9 +328,42 @@ flv_reader_c::read_headers() {
 
   m_in->setFilePointer(9, seek_beginning); // rewind file for later remux
   m_file_done = false;
+  m_stats     = stats_t{};
 }
 
 flv_reader_c::~flv_reader_c() {
+  if (m_debug_stats)
+    dump_stats();
+}
+
+void
+flv_reader_c::count_tag() {
+  auto &tag_stats = m_tag.is_audio()       ? m_stats.audio
+                  : m_tag.is_video()       ? m_stats.video
+                  : m_tag.is_script_data() ? m_stats.script_data
+                  :                          m_stats.other;
+
+  ++tag_stats.num_tags;
+  tag_stats.num_bytes += m_tag.m_data_size;
+}
+
+void
+flv_reader_c::dump_stats() {
+  auto num_tags = m_stats.audio.num_tags + m_stats.video.num_tags + m_stats.script_data.num_tags + m_stats.other.num_tags;
+  if (!num_tags)
+    return;
+
+  mxdebug(boost::format("FLV tag statistics: %1% tags, %2% bytes of payload delivered\n") % num_tags % m_stats.num_payload_bytes);
+
+  auto dump = [](std::string const &type, tag_stats_t const &tag_stats) {
+    if (tag_stats.num_tags)
+      mxdebug(boost::format("  %1%: %2% tags, %3% bytes, %4% bytes per tag on average\n") % type % tag_stats.num_tags % tag_stats.num_bytes % (tag_stats.num_bytes / tag_stats.num_tags));
+  };
+
+  dump("audio",       m_stats.audio);
+  dump("video",       m_stats.video);
+  dump("script data", m_stats.script_data);
+  dump("other",       m_stats.other);
 }
 
 void
@@ -452,7 +493,8 @@ flv_reader_c::new_stream_v_avc(flv_track_cptr &track,
 
 bool
 flv_reader_c::process_audio_tag_sound_format(flv_track_cptr &track,
-                                             uint8_t sound_format) {
+                                             uint8_t sound_format,
+                                             mm_io_c &body) {
   static const std::vector<std::string> s_formats{
       "Linear PCM platform endian"
     , "ADPCM"
@@ -483,7 +525,7 @@ flv_reader_c::process_audio_tag_sound_format(flv_track_cptr &track,
       return false;
 
     track->m_fourcc = "AAC ";
-    uint8_t aac_packet_type = m_in->read_uint8();
+    uint8_t aac_packet_type = body.read_uint8();
     m_tag.m_data_size--;
     if (aac_packet_type != 0) {
       // Raw AAC
@@ -498,7 +540,7 @@ flv_reader_c::process_audio_tag_sound_format(flv_track_cptr &track,
     m_tag.m_data_size -= size;
 
     unsigned char specific_codec_buf[5];
-    if (m_in->read(specific_codec_buf, size) != size)
+    if (body.read(specific_codec_buf, size) != size)
        return false;
 
     int profile, channels, sample_rate, output_sample_rate;
@@ -528,8 +570,9 @@ flv_reader_c::process_audio_tag_sound_format(flv_track_cptr &track,
 }
 
 bool
-flv_reader_c::process_audio_tag(flv_track_cptr &track) {
-  uint8_t audiotag_header = m_in->read_uint8();
+flv_reader_c::process_audio_tag(flv_track_cptr &track,
+                                mm_io_c &body) {
+  uint8_t audiotag_header = body.read_uint8();
   uint8_t format          = (audiotag_header & 0xf0) >> 4;
   uint8_t rate            = (audiotag_header & 0x0c) >> 2;
   uint8_t size            = (audiotag_header & 0x02) >> 1;
@@ -541,7 +584,7 @@ flv_reader_c::process_audio_tag(flv_track_cptr &track) {
     return false;
   m_tag.m_data_size--;
 
-  process_audio_tag_sound_format(track, format);
+  process_audio_tag_sound_format(track, format, body);
 
   if (!track->m_a_sample_rate && (4 > rate)) {
     static unsigned int s_rates[] = { 5512, 11025, 22050, 44100 };
@@ -561,13 +604,14 @@ flv_reader_c::process_audio_tag(flv_track_cptr &track) {
 }
 
 bool
-flv_reader_c::process_video_tag_avc(flv_track_cptr &track) {
+flv_reader_c::process_video_tag_avc(flv_track_cptr &track,
+                                    mm_io_c &body) {
   if (4 > m_tag.m_data_size)
     return false;
 
   track->m_fourcc          = "AVC1";
-  uint8_t avc_packet_type  = m_in->read_uint8();
-  track->m_v_cts_offset    = m_in->read_int24_be();
+  uint8_t avc_packet_type  = body.read_uint8();
+  track->m_v_cts_offset    = body.read_int24_be();
   m_tag.m_data_size       -= 4;
 
   // The CTS offset is only valid for NALUs.
@@ -578,9 +622,9 @@ flv_reader_c::process_video_tag_avc(flv_track_cptr &track) {
   if (0 != avc_packet_type)
     return true;
 
-  mxdebug_if(m_debug, boost::format("  AVC sequence header at %1%\n") % m_in->getFilePointer());
+  mxdebug_if(m_debug, boost::format("  AVC sequence header at %1%\n") % (m_tag.m_next_position - m_tag.m_data_size));
 
-  auto data         = m_in->read(m_tag.m_data_size);
+  auto data         = body.read(m_tag.m_data_size);
   m_tag.m_data_size = 0;
 
   if (!track->m_headers_read) {
@@ -599,7 +643,8 @@ flv_reader_c::process_video_tag_avc(flv_track_cptr &track) {
 
 bool
 flv_reader_c::process_video_tag_generic(flv_track_cptr &track,
-                                        flv_tag_c::codec_type_e codec_id) {
+                                        flv_tag_c::codec_type_e codec_id,
+                                        mm_io_c &body) {
   track->m_fourcc       = flv_tag_c::CODEC_SORENSON_H263  == codec_id ? "FLV1"
                         : flv_tag_c::CODEC_VP6            == codec_id ? "VP6F"
                         : flv_tag_c::CODEC_VP6_WITH_ALPHA == codec_id ? "VP6A"
@@ -609,7 +654,7 @@ flv_reader_c::process_video_tag_generic(flv_track_cptr &track,
     if (!m_tag.m_data_size)
       return false;
     m_tag.m_data_size--;
-    m_in->skip(1);
+    body.skip(1);
     track->m_headers_read = true;
 
   } else if (track->m_fourcc == "FLV1")
@@ -620,7 +665,8 @@ flv_reader_c::process_video_tag_generic(flv_track_cptr &track,
 }
 
 bool
-flv_reader_c::process_video_tag(flv_track_cptr &track) {
+flv_reader_c::process_video_tag(flv_track_cptr &track,
+                                mm_io_c &body) {
   static struct {
     std::string name;
     bool is_key;
@@ -637,7 +683,7 @@ flv_reader_c::process_video_tag(flv_track_cptr &track) {
   if (!m_tag.m_data_size)
     return false;
 
-  uint8_t video_tag_header = m_in->read_uint8();
+  uint8_t video_tag_header = body.read_uint8();
   m_tag.m_data_size--;
 
   uint8_t frame_type = (video_tag_header >> 4) & 0x0f;
@@ -666,12 +712,12 @@ flv_reader_c::process_video_tag(flv_track_cptr &track) {
     mxdebug_if(m_debug, boost::format("  Codec type: %1%\n") % s_codecs[codec_id - flv_tag_c::CODEC_SORENSON_H263]);
 
     if (flv_tag_c::CODEC_H264 == codec_id)
-      return process_video_tag_avc(track);
+      return process_video_tag_avc(track, body);
 
     else if (   (flv_tag_c::CODEC_SORENSON_H263  == codec_id)
              || (flv_tag_c::CODEC_VP6            == codec_id)
              || (flv_tag_c::CODEC_VP6_WITH_ALPHA == codec_id))
-      return process_video_tag_generic(track, codec_id);
+      return process_video_tag_generic(track, codec_id, body);
 
     else
       track->m_headers_read = true;
@@ -725,6 +771,8 @@ flv_reader_c::process_tag(bool skip_payload) {
     return false;
   }
 
+  count_tag();
+
   if (m_tag.is_encrypted())
     return false;
 
@@ -741,12 +789,20 @@ flv_reader_c::process_tag(bool skip_payload) {
   if ((0 > m_selected_track_idx) || (static_cast<int>(m_tracks.size()) <= m_selected_track_idx))
     return false;
 
+  if (!m_tag.m_data_size)
+    return false;
+
   auto &track = m_tracks[m_selected_track_idx];
 
-  if (m_tag.is_audio() && !process_audio_tag(track))
+  // The whole tag is read at once. Its header fields are parsed from
+  // memory, and the payload is the rest of the same buffer.
+  auto data = m_in->read(m_tag.m_data_size);
+  mm_mem_io_c body{*data};
+
+  if (m_tag.is_audio() && !process_audio_tag(track, body))
     return false;
 
-  else if (m_tag.is_video() && !process_video_tag(track))
+  else if (m_tag.is_video() && !process_video_tag(track, body))
     return false;
 
   track->m_timecode = m_tag.m_timecode + (m_tag.m_timecode_extended << 24);
@@ -756,7 +812,9 @@ flv_reader_c::process_tag(bool skip_payload) {
   if (!m_tag.m_data_size)
     return true;
 
-  track->m_payload = m_in->read(m_tag.m_data_size);
+  data->set_offset(body.getFilePointer());
+  track->m_payload           = data;
+  m_stats.num_payload_bytes += data->get_size();
 
   track->postprocess_header_data();
 
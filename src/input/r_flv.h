@@ -137,7 +137,27 @@ private:
 
   std::vector<flv_track_cptr> m_tracks;
 
-  debugging_option_c m_debug;
+  debugging_option_c m_debug, m_debug_stats;
+
+  struct tag_stats_t {
+    uint64_t num_tags, num_bytes;
+
+    tag_stats_t()
+      : num_tags{}
+      , num_bytes{}
+    {
+    }
+  };
+
+  struct stats_t {
+    tag_stats_t audio, video, script_data, other;
+    uint64_t num_payload_bytes;
+
+    stats_t()
+      : num_payload_bytes{}
+    {
+    }
+  } m_stats;
 
 public:
   flv_reader_c(const track_info_c &ti, const mm_io_cptr &in);
@@ -159,11 +179,14 @@ public:
 protected:
   bool process_tag(bool skip_payload = false);
   bool process_script_tag();
-  bool process_audio_tag(flv_track_cptr &track);
-  bool process_audio_tag_sound_format(flv_track_cptr &track, uint8_t sound_format);
-  bool process_video_tag(flv_track_cptr &track);
-  bool process_video_tag_avc(flv_track_cptr &track);
-  bool process_video_tag_generic(flv_track_cptr &track, flv_tag_c::codec_type_e codec_id);
+  bool process_audio_tag(flv_track_cptr &track, mm_io_c &body);
+  bool process_audio_tag_sound_format(flv_track_cptr &track, uint8_t sound_format, mm_io_c &body);
+  bool process_video_tag(flv_track_cptr &track, mm_io_c &body);
+  bool process_video_tag_avc(flv_track_cptr &track, mm_io_c &body);
+  bool process_video_tag_generic(flv_track_cptr &track, flv_tag_c::codec_type_e codec_id, mm_io_c &body);
+
+  void count_tag();
+  void dump_stats();
 
   void create_a_aac_packetizer(flv_track_cptr &track);
   void create_a_mp3_packetizer(flv_track_cptr &track);
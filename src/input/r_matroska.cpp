@@ -31,6 +31,8 @@
 #include <matroska/KaxCluster.h>
 #include <matroska/KaxClusterData.h>
 #include <matroska/KaxContexts.h>
+#include <matroska/KaxCues.h>
+#include <matroska/KaxCuesData.h>
 #include <matroska/KaxInfo.h>
 #include <matroska/KaxInfoData.h>
 #include <matroska/KaxSeekHead.h>
@@ -205,8 +207,11 @@ kax_reader_c::kax_reader_c(const track_info_c &ti,
   , m_first_timecode(-1)
   , m_writing_app_ver(-1)
   , m_attachment_id(0)
+  , m_segment_data_start(0)
+  , m_cues_parsed(false)
   , m_file_status(FILE_STATUS_MOREDATA)
   , m_opus_experimental_warning_shown{}
+  , m_debug_skipping{"skip_to_timecode"}
 {
   init_l1_position_storage(m_deferred_l1_positions);
   init_l1_position_storage(m_handled_l1_positions);
@@ -222,6 +227,7 @@ kax_reader_c::init_l1_position_storage(deferred_positions_t &storage) {
   storage[dl1t_tags]        = std::vector<int64_t>();
   storage[dl1t_tracks]      = std::vector<int64_t>();
   storage[dl1t_seek_head]   = std::vector<int64_t>();
+  storage[dl1t_cues]        = std::vector<int64_t>();
 }
 
 bool
@@ -754,6 +760,74 @@ kax_reader_c::handle_tags(mm_io_c *io,
   }
 }
 
+void
+kax_reader_c::handle_cues() {
+  if (m_cues_parsed)
+    return;
+
+  m_cues_parsed = true;
+
+  // Prefer the cue points of video tracks that are actually muxed as
+  // those are the ones that point to usable key frames.
+  std::unordered_map<uint64_t, bool> video_track_nums;
+  for (auto &track : m_tracks)
+    if ((-1 != track->ptzr) && ('v' == track->type))
+      video_track_nums[track->track_number] = true;
+
+  for (auto position : m_deferred_l1_positions[dl1t_cues]) {
+    if (has_deferred_element_been_processed(dl1t_cues, position))
+      continue;
+
+    m_in->save_pos(position);
+    at_scope_exit_c restore([&]() { m_in->restore_pos(); });
+
+    try {
+      int upper_lvl_el = 0;
+      std::shared_ptr<EbmlElement> l1(m_es->FindNextElement(EBML_CLASS_CONTEXT(KaxSegment), upper_lvl_el, 0xFFFFFFFFL, true));
+      auto cues = dynamic_cast<KaxCues *>(l1.get());
+
+      if (!cues)
+        continue;
+
+      EbmlElement *l2 = nullptr;
+      upper_lvl_el    = 0;
+
+      cues->Read(*m_es, EBML_CLASS_CONTEXT(KaxCues), upper_lvl_el, l2, true);
+
+      for (auto l2 : *cues) {
+        if (!Is<KaxCuePoint>(l2))
+          continue;
+
+        auto &cue_point = *static_cast<KaxCuePoint *>(l2);
+        auto cue_time   = FindChildValue<KaxCueTime, int64_t>(cue_point, -1);
+
+        if (-1 == cue_time)
+          continue;
+
+        for (auto l3 : cue_point) {
+          if (!Is<KaxCueTrackPositions>(l3))
+            continue;
+
+          auto &track_positions = *static_cast<KaxCueTrackPositions *>(l3);
+          auto track_num        = FindChildValue<KaxCueTrack, uint64_t>(track_positions, 0);
+          auto cluster_position = FindChildValue<KaxCueClusterPosition, int64_t>(track_positions, -1);
+
+          if ((-1 == cluster_position) || (!video_track_nums.empty() && !video_track_nums[track_num]))
+            continue;
+
+          m_cue_cluster_positions.emplace_back(cue_time * m_tc_scale, m_segment_data_start + cluster_position);
+        }
+      }
+
+    } catch (...) {
+    }
+  }
+
+  brng::sort(m_cue_cluster_positions);
+
+  mxdebug_if(m_debug_skipping, boost::format("matroska_reader: %1% usable cue points found\n") % m_cue_cluster_positions.size());
+}
+
 void
 kax_reader_c::read_headers_info(mm_io_c *io,
                                 EbmlElement *l0,
@@ -1068,6 +1142,7 @@ kax_reader_c::handle_seek_head(mm_io_c *io,
         :                       Is<KaxTracks>(id)      ? dl1t_tracks
         :                       Is<KaxSeekHead>(id)    ? dl1t_seek_head
         :                       Is<KaxInfo>(id)        ? dl1t_info
+        :                       Is<KaxCues>(id)        ? dl1t_cues
         :                                                dl1t_unknown;
 
       if (dl1t_unknown == type)
@@ -1130,6 +1205,8 @@ kax_reader_c::read_headers_internal() {
       return false;
     }
 
+    m_segment_data_start = l0->GetElementPosition() + l0->HeadSize();
+
     // We've got our segment, so let's find the m_tracks
     int upper_lvl_el = 0;
     m_tc_scale         = TIMECODE_SCALE;
@@ -1151,6 +1228,9 @@ kax_reader_c::read_headers_internal() {
       else if (Is<KaxTags>(l1))
         m_deferred_l1_positions[dl1t_tags].push_back(l1->GetElementPosition());
 
+      else if (Is<KaxCues>(l1))
+        m_deferred_l1_positions[dl1t_cues].push_back(l1->GetElementPosition());
+
       else if (Is<KaxSeekHead>(l1))
         handle_seek_head(m_in.get(), l0, l1->GetElementPosition());
 
@@ -1845,13 +1925,10 @@ kax_reader_c::read(generic_packetizer_c *requested_ptzr,
   if (m_tracks.empty() || (FILE_STATUS_DONE == m_file_status))
     return FILE_STATUS_DONE;
 
-  if (!force) {
-    auto num_queued_bytes = get_queued_bytes();
-    if (20 * 1024 * 1024 < num_queued_bytes) {
-      kax_track_t *requested_ptzr_track = m_ptzr_to_track_map[requested_ptzr];
-      if (!requested_ptzr_track || (('a' != requested_ptzr_track->type) && ('v' != requested_ptzr_track->type)) || (512 * 1024 * 1024 < num_queued_bytes))
-        return FILE_STATUS_HOLDING;
-    }
+  if (!force && queued_bytes_exceed(20 * 1024 * 1024)) {
+    kax_track_t *requested_ptzr_track = m_ptzr_to_track_map[requested_ptzr];
+    if (!requested_ptzr_track || (('a' != requested_ptzr_track->type) && ('v' != requested_ptzr_track->type)) || queued_bytes_exceed(512 * 1024 * 1024))
+      return FILE_STATUS_HOLDING;
   }
 
   try {
@@ -1897,6 +1974,35 @@ kax_reader_c::read(generic_packetizer_c *requested_ptzr,
   return FILE_STATUS_MOREDATA;
 }
 
+bool
+kax_reader_c::skip_to_timecode(timecode_c const &timecode) {
+  if (m_tracks.empty() || (FILE_STATUS_DONE == m_file_status))
+    return false;
+
+  handle_cues();
+
+  // Find the last cue point at or before the wanted timecode. Only
+  // ever skip forward; data before the current position has already
+  // been handed to the packetizers.
+  auto itr = brng::upper_bound(m_cue_cluster_positions, std::make_pair(timecode.to_ns(), std::numeric_limits<int64_t>::max()));
+  if (m_cue_cluster_positions.begin() == itr)
+    return false;
+
+  auto current_position = static_cast<int64_t>(m_in->getFilePointer());
+  auto new_position     = (itr - 1)->second;
+
+  mxdebug_if(m_debug_skipping,
+             boost::format("matroska_reader: skip to %1%: cue at %2% position %3% current position %4%\n")
+             % format_timecode(timecode) % format_timecode((itr - 1)->first) % new_position % current_position);
+
+  if (new_position <= current_position)
+    return false;
+
+  m_in->setFilePointer(new_position, seek_beginning);
+
+  return true;
+}
+
 void
 kax_reader_c::process_simple_block(KaxCluster *cluster,
                                    KaxSimpleBlock *block_simple) {
@@ -167,6 +167,7 @@ private:
     dl1t_tracks,
     dl1t_seek_head,
     dl1t_info,
+    dl1t_cues,
   };
 
   std::vector<kax_track_cptr> m_tracks;
@@ -184,6 +185,10 @@ private:
   typedef std::map<deferred_l1_type_e, std::vector<int64_t> > deferred_positions_t;
   deferred_positions_t m_deferred_l1_positions, m_handled_l1_positions;
 
+  int64_t m_segment_data_start;
+  bool m_cues_parsed;
+  std::vector<std::pair<int64_t, int64_t> > m_cue_cluster_positions; // timecode in ns, absolute cluster position
+
   std::string m_writing_app, m_muxing_app;
   int64_t m_writing_app_ver;
 
@@ -197,6 +202,8 @@ private:
 
   bool m_opus_experimental_warning_shown;
 
+  debugging_option_c m_debug_skipping;
+
 public:
   kax_reader_c(const track_info_c &ti, const mm_io_cptr &in);
   virtual ~kax_reader_c();
@@ -207,6 +214,7 @@ public:
 
   virtual void read_headers();
   virtual file_status_e read(generic_packetizer_c *ptzr, bool force = false);
+  virtual bool skip_to_timecode(timecode_c const &timecode);
 
   virtual int get_progress();
   virtual void set_headers();
@@ -245,6 +253,7 @@ protected:
   virtual void handle_chapters(mm_io_c *io, EbmlElement *l0, int64_t pos);
   virtual void handle_seek_head(mm_io_c *io, EbmlElement *l0, int64_t pos);
   virtual void handle_tags(mm_io_c *io, EbmlElement *l0, int64_t pos);
+  virtual void handle_cues();
   virtual void process_global_tags();
 
   virtual bool unlace_vorbis_private_data(kax_track_t *t, unsigned char *buffer, int size);
@@ -1201,10 +1201,9 @@ mpeg_ps_reader_c::read(generic_packetizer_c *requested_ptzr,
   if (file_done)
     return flush_packetizers();
 
-  auto num_queued_bytes = get_queued_bytes();
-  if (!force && (20 * 1024 * 1024 < num_queued_bytes)) {
+  if (!force && queued_bytes_exceed(20 * 1024 * 1024)) {
     mpeg_ps_track_ptr requested_ptzr_track = m_ptzr_to_track_map[requested_ptzr];
-    if (!requested_ptzr_track || (('a' != requested_ptzr_track->type) && ('v' != requested_ptzr_track->type)) || (64 * 1024 * 1024 < num_queued_bytes))
+    if (!requested_ptzr_track || (('a' != requested_ptzr_track->type) && ('v' != requested_ptzr_track->type)) || queued_bytes_exceed(64 * 1024 * 1024))
       return FILE_STATUS_HOLDING;
   }
 
@@ -1222,10 +1222,9 @@ mpeg_ts_reader_c::finish() {
 file_status_e
 mpeg_ts_reader_c::read(generic_packetizer_c *requested_ptzr,
                        bool force) {
-  int64_t num_queued_bytes = get_queued_bytes();
-  if (!force && (20 * 1024 * 1024 < num_queued_bytes)) {
+  if (!force && queued_bytes_exceed(20 * 1024 * 1024)) {
     mpeg_ts_track_ptr requested_ptzr_track = m_ptzr_to_track_map[requested_ptzr];
-    if (!requested_ptzr_track || ((ES_AUDIO_TYPE != requested_ptzr_track->type) && (ES_VIDEO_TYPE != requested_ptzr_track->type)) || (512 * 1024 * 1024 < num_queued_bytes))
+    if (!requested_ptzr_track || ((ES_AUDIO_TYPE != requested_ptzr_track->type) && (ES_VIDEO_TYPE != requested_ptzr_track->type)) || queued_bytes_exceed(512 * 1024 * 1024))
       return FILE_STATUS_HOLDING;
   }
 
@@ -662,7 +662,7 @@ ogm_reader_c::read(generic_packetizer_c *,
                    bool) {
   // Some tracks may contain huge gaps. We don't want to suck in the complete
   // file.
-  if (get_queued_bytes() > 20 * 1024 * 1024)
+  if (queued_bytes_exceed(20 * 1024 * 1024))
     return FILE_STATUS_HOLDING;
 
   ogg_page og;
@@ -131,6 +131,7 @@ qtmp4_reader_c::qtmp4_reader_c(const track_info_c &ti,
   , m_debug_tables{            "qtmp4_full|qtmp4_tables"}
   , m_debug_interleaving{"qtmp4|qtmp4_full|qtmp4_interleaving"}
   , m_debug_resync{      "qtmp4|qtmp4_full|qtmp4_resync"}
+  , m_debug_skipping{    "qtmp4|qtmp4_full|skip_to_timecode"}
 {
 }
 
@@ -299,8 +300,10 @@ qtmp4_reader_c::calculate_timecodes() {
     for (auto &dmx : m_demuxers)
       dmx->adjust_timecodes(-min_timecode);
 
-  for (auto &dmx : m_demuxers)
+  for (auto &dmx : m_demuxers) {
     dmx->build_index();
+    dmx->release_tables();
+  }
 }
 
 void
@@ -399,20 +402,49 @@ qtmp4_reader_c::handle_cmvd_atom(qt_atom_t atom,
   m_in = old_in;
 }
 
+memory_cptr
+qtmp4_reader_c::read_table_entries(qt_atom_t const &atom,
+                                   uint32_t &num_entries,
+                                   size_t entry_size) {
+  // Sample tables can contain millions of entries. Reading them in one
+  // go is a lot faster than reading each field individually. Damaged
+  // files sometimes claim more entries than the atom can hold; those
+  // are ignored.
+  auto atom_end        = atom.pos + atom.size;
+  auto current_pos     = m_in->getFilePointer();
+  uint64_t available   = atom_end > current_pos ? (atom_end - current_pos) / entry_size : 0;
+
+  if (num_entries > available) {
+    mxdebug_if(m_debug_headers, boost::format("Table in atom %1% claims %2% entries but only has room for %3%\n") % atom % num_entries % available);
+    num_entries = available;
+  }
+
+  auto buffer = memory_c::alloc(std::max<size_t>(num_entries * entry_size, 1));
+  if (m_in->read(buffer->get_buffer(), num_entries * entry_size) != (num_entries * entry_size))
+    throw mtx::mm_io::end_of_file_x();
+
+  return buffer;
+}
+
 void
 qtmp4_reader_c::handle_ctts_atom(qtmp4_demuxer_cptr &new_dmx,
-                                 qt_atom_t,
+                                 qt_atom_t atom,
                                  int level) {
   m_in->skip(1 + 3);        // version & flags
   uint32_t count = m_in->read_uint32_be();
   mxdebug_if(m_debug_headers, boost::format("%1%Frame offset table: %2% raw entries\n") % space(level * 2 + 1) % count);
 
+  auto buffer = read_table_entries(atom, count, 2 * 4);
+  auto ptr    = buffer->get_buffer();
+
+  new_dmx->raw_frame_offset_table.reserve(new_dmx->raw_frame_offset_table.size() + count);
+
   size_t i;
-  for (i = 0; i < count; ++i) {
+  for (i = 0; i < count; ++i, ptr += 2 * 4) {
     qt_frame_offset_t frame_offset;
 
-    frame_offset.count  = m_in->read_uint32_be();
-    frame_offset.offset = m_in->read_uint32_be();
+    frame_offset.count  = get_uint32_be(ptr);
+    frame_offset.offset = get_uint32_be(ptr + 4);
     new_dmx->raw_frame_offset_table.push_back(frame_offset);
   }
 
@@ -837,18 +869,23 @@ qtmp4_reader_c::handle_stbl_atom(qtmp4_demuxer_cptr &new_dmx,
 
 void
 qtmp4_reader_c::handle_stco_atom(qtmp4_demuxer_cptr &new_dmx,
-                                 qt_atom_t,
+                                 qt_atom_t atom,
                                  int level) {
   m_in->skip(1 + 3);        // version & flags
   uint32_t count = m_in->read_uint32_be();
 
   mxdebug_if(m_debug_headers, boost::format("%1%Chunk offset table: %2% entries\n") % space(level * 2 + 1) % count);
 
+  auto buffer = read_table_entries(atom, count, 4);
+  auto ptr    = buffer->get_buffer();
+
+  new_dmx->chunk_table.reserve(new_dmx->chunk_table.size() + count);
+
   size_t i;
-  for (i = 0; i < count; ++i) {
+  for (i = 0; i < count; ++i, ptr += 4) {
     qt_chunk_t chunk;
 
-    chunk.pos = m_in->read_uint32_be();
+    chunk.pos = get_uint32_be(ptr);
     new_dmx->chunk_table.push_back(chunk);
   }
 
@@ -859,18 +896,23 @@ qtmp4_reader_c::handle_stco_atom(qtmp4_demuxer_cptr &new_dmx,
 
 void
 qtmp4_reader_c::handle_co64_atom(qtmp4_demuxer_cptr &new_dmx,
-                                 qt_atom_t,
+                                 qt_atom_t atom,
                                  int level) {
   m_in->skip(1 + 3);        // version & flags
   uint32_t count = m_in->read_uint32_be();
 
   mxdebug_if(m_debug_headers, boost::format("%1%64bit chunk offset table: %2% entries\n") % space(level * 2 + 1) % count);
 
+  auto buffer = read_table_entries(atom, count, 8);
+  auto ptr    = buffer->get_buffer();
+
+  new_dmx->chunk_table.reserve(new_dmx->chunk_table.size() + count);
+
   size_t i;
-  for (i = 0; i < count; ++i) {
+  for (i = 0; i < count; ++i, ptr += 8) {
     qt_chunk_t chunk;
 
-    chunk.pos = m_in->read_uint64_be();
+    chunk.pos = get_uint64_be(ptr);
     new_dmx->chunk_table.push_back(chunk);
   }
 
@@ -881,17 +923,22 @@ qtmp4_reader_c::handle_co64_atom(qtmp4_demuxer_cptr &new_dmx,
 
 void
 qtmp4_reader_c::handle_stsc_atom(qtmp4_demuxer_cptr &new_dmx,
-                                 qt_atom_t,
+                                 qt_atom_t atom,
                                  int level) {
   m_in->skip(1 + 3);        // version & flags
   uint32_t count = m_in->read_uint32_be();
+  auto buffer    = read_table_entries(atom, count, 3 * 4);
+  auto ptr       = buffer->get_buffer();
+
+  new_dmx->chunkmap_table.reserve(new_dmx->chunkmap_table.size() + count);
+
   size_t i;
-  for (i = 0; i < count; ++i) {
+  for (i = 0; i < count; ++i, ptr += 3 * 4) {
     qt_chunkmap_t chunkmap;
 
-    chunkmap.first_chunk           = m_in->read_uint32_be() - 1;
-    chunkmap.samples_per_chunk     = m_in->read_uint32_be();
-    chunkmap.sample_description_id = m_in->read_uint32_be();
+    chunkmap.first_chunk           = get_uint32_be(ptr) - 1;
+    chunkmap.samples_per_chunk     = get_uint32_be(ptr + 4);
+    chunkmap.sample_description_id = get_uint32_be(ptr + 8);
     new_dmx->chunkmap_table.push_back(chunkmap);
   }
 
@@ -933,14 +980,18 @@ qtmp4_reader_c::handle_stsd_atom(qtmp4_demuxer_cptr &new_dmx,
 
 void
 qtmp4_reader_c::handle_stss_atom(qtmp4_demuxer_cptr &new_dmx,
-                                 qt_atom_t,
+                                 qt_atom_t atom,
                                  int level) {
   m_in->skip(1 + 3);        // version & flags
   uint32_t count = m_in->read_uint32_be();
+  auto buffer    = read_table_entries(atom, count, 4);
+  auto ptr       = buffer->get_buffer();
+
+  new_dmx->keyframe_table.reserve(new_dmx->keyframe_table.size() + count);
 
   size_t i;
-  for (i = 0; i < count; ++i)
-    new_dmx->keyframe_table.push_back(m_in->read_uint32_be());
+  for (i = 0; i < count; ++i, ptr += 4)
+    new_dmx->keyframe_table.push_back(get_uint32_be(ptr));
 
   std::sort(new_dmx->keyframe_table.begin(), new_dmx->keyframe_table.end());
 
@@ -952,18 +1003,23 @@ qtmp4_reader_c::handle_stss_atom(qtmp4_demuxer_cptr &new_dmx,
 
 void
 qtmp4_reader_c::handle_stsz_atom(qtmp4_demuxer_cptr &new_dmx,
-                                 qt_atom_t,
+                                 qt_atom_t atom,
                                  int level) {
   m_in->skip(1 + 3);        // version & flags
   uint32_t sample_size = m_in->read_uint32_be();
   uint32_t count       = m_in->read_uint32_be();
 
   if (0 == sample_size) {
+    auto buffer = read_table_entries(atom, count, 4);
+    auto ptr    = buffer->get_buffer();
+
+    new_dmx->sample_table.reserve(new_dmx->sample_table.size() + count);
+
     size_t i;
-    for (i = 0; i < count; ++i) {
+    for (i = 0; i < count; ++i, ptr += 4) {
       qt_sample_t sample;
 
-      sample.size = m_in->read_uint32_be();
+      sample.size = get_uint32_be(ptr);
 
       // This is a sanity check against damaged samples. I have one of
       // those in which one sample was suppposed to be > 2GB big.
@@ -988,17 +1044,21 @@ qtmp4_reader_c::handle_stsz_atom(qtmp4_demuxer_cptr &new_dmx,
 
 void
 qtmp4_reader_c::handle_sttd_atom(qtmp4_demuxer_cptr &new_dmx,
-                                 qt_atom_t,
+                                 qt_atom_t atom,
                                  int level) {
   m_in->skip(1 + 3);        // version & flags
   uint32_t count = m_in->read_uint32_be();
+  auto buffer    = read_table_entries(atom, count, 2 * 4);
+  auto ptr       = buffer->get_buffer();
+
+  new_dmx->durmap_table.reserve(new_dmx->durmap_table.size() + count);
 
   size_t i;
-  for (i = 0; i < count; ++i) {
+  for (i = 0; i < count; ++i, ptr += 2 * 4) {
     qt_durmap_t durmap;
 
-    durmap.number   = m_in->read_uint32_be();
-    durmap.duration = m_in->read_uint32_be();
+    durmap.number   = get_uint32_be(ptr);
+    durmap.duration = get_uint32_be(ptr + 4);
     new_dmx->durmap_table.push_back(durmap);
   }
 
@@ -1012,17 +1072,21 @@ qtmp4_reader_c::handle_sttd_atom(qtmp4_demuxer_cptr &new_dmx,
 
 void
 qtmp4_reader_c::handle_stts_atom(qtmp4_demuxer_cptr &new_dmx,
-                                 qt_atom_t,
+                                 qt_atom_t atom,
                                  int level) {
   m_in->skip(1 + 3);        // version & flags
   uint32_t count = m_in->read_uint32_be();
+  auto buffer    = read_table_entries(atom, count, 2 * 4);
+  auto ptr       = buffer->get_buffer();
+
+  new_dmx->durmap_table.reserve(new_dmx->durmap_table.size() + count);
 
   size_t i;
-  for (i = 0; i < count; ++i) {
+  for (i = 0; i < count; ++i, ptr += 2 * 4) {
     qt_durmap_t durmap;
 
-    durmap.number   = m_in->read_uint32_be();
-    durmap.duration = m_in->read_uint32_be();
+    durmap.number   = get_uint32_be(ptr);
+    durmap.duration = get_uint32_be(ptr + 4);
     new_dmx->durmap_table.push_back(durmap);
   }
 
@@ -1216,6 +1280,45 @@ qtmp4_reader_c::read(generic_packetizer_c *ptzr,
   return flush_packetizers();
 }
 
+bool
+qtmp4_reader_c::skip_to_timecode(timecode_c const &timecode) {
+  auto skipped = false;
+
+  for (auto &dmx : m_demuxers) {
+    if ((-1 == dmx->ptzr) || (dmx->pos >= dmx->m_index.size()))
+      continue;
+
+    // The decoder config of MPEG-4 part 2 video is prepended to the
+    // very first frame only.
+    if (!dmx->pos && dmx->is_video() && dmx->codec.is(CT_V_MPEG4_P2) && dmx->esds_parsed && dmx->esds.decoder_config)
+      continue;
+
+    // The index is in decoding order. Key frames are never reordered,
+    // so the scan can stop at the first key frame past the target.
+    auto target_pos = dmx->pos;
+
+    for (auto pos = dmx->pos; pos < dmx->m_index.size(); ++pos) {
+      auto &index = dmx->m_index[pos];
+      if (!index.is_keyframe)
+        continue;
+      if (index.timecode > timecode.to_ns())
+        break;
+      target_pos = pos;
+    }
+
+    mxdebug_if(m_debug_skipping,
+               boost::format("Quicktime/MP4 reader: skip to %1%: track %2% from entry %3% to %4%\n")
+               % format_timecode(timecode) % dmx->id % dmx->pos % target_pos);
+
+    if (target_pos > dmx->pos) {
+      dmx->pos = target_pos;
+      skipped  = true;
+    }
+  }
+
+  return skipped;
+}
+
 memory_cptr
 qtmp4_reader_c::create_bitmap_info_header(qtmp4_demuxer_cptr &dmx,
                                           const char *fourcc,
@@ -1310,7 +1413,7 @@ qtmp4_reader_c::create_video_packetizer_mpeg1_2(qtmp4_demuxer_cptr &dmx) {
 
 void
 qtmp4_reader_c::create_video_packetizer_mpeg4_p10(qtmp4_demuxer_cptr &dmx) {
-  if (dmx->frame_offset_table.empty())
+  if (dmx->raw_frame_offset_table.empty())
     mxwarn_tid(m_ti.m_fname, dmx->id,
                Y("The AVC video track is missing the 'CTTS' atom for frame timecode offsets. "
                  "However, AVC/h.264 allows frames to have more than the traditional one (for P frames) or two (for B frames) references to other frames. "
@@ -1537,9 +1640,10 @@ qtmp4_reader_c::get_progress() {
     return 100;
 
   qtmp4_demuxer_cptr &dmx = m_demuxers[m_main_dmx];
-  unsigned int max_chunks = (0 == dmx->sample_size) ? dmx->sample_table.size() : dmx->chunk_table.size();
+  if (dmx->m_index.empty())
+    return 100;
 
-  return 100 * dmx->pos / max_chunks;
+  return 100 * dmx->pos / dmx->m_index.size();
 }
 
 void
@@ -1622,6 +1726,11 @@ qtmp4_reader_c::recode_chapter_entries(std::vector<qtmp4_chapter_entry_t> &entri
 
 void
 qtmp4_reader_c::detect_interleaving() {
+  // Only relevant for reading frames, and the sample positions haven't
+  // been calculated in identification mode.
+  if (g_identifying)
+    return;
+
   std::list<qtmp4_demuxer_cptr> demuxers_to_read;
   boost::remove_copy_if(m_demuxers, std::back_inserter(demuxers_to_read), [&](const qtmp4_demuxer_cptr &dmx) {
       return !(dmx->ok && (dmx->is_audio() || dmx->is_video()) && demuxing_requested(dmx->type, dmx->id) && (dmx->sample_table.size() > 1));
@@ -1695,6 +1804,10 @@ qtmp4_demuxer_c::to_nsecs(int64_t value) {
 
 void
 qtmp4_demuxer_c::calculate_timecodes_constant_sample_size() {
+  timecodes.reserve(chunk_table.size());
+  durations.reserve(chunk_table.size());
+  frame_indices.reserve(chunk_table.size());
+
   auto frame = 0u;
   for (auto &chunk : chunk_table) {
     timecodes.push_back(to_nsecs(static_cast<uint64_t>(chunk.samples) * duration) + constant_editlist_offset_ns);
@@ -1710,7 +1823,11 @@ qtmp4_demuxer_c::calculate_timecodes_variable_sample_size() {
   bool is_avc                  = codec.is(CT_V_MPEG4_P10);
   int64_t v_dts_offset         = is_avc && num_frame_offsets ? to_nsecs(frame_offset_table[0]) : 0;
 
-  std::vector<int64_t> timecodes_before_offsets;
+  int64_t avg_duration = 0, num_good_frames = 0, previous_timecode = 0;
+
+  timecodes.reserve(sample_table.size());
+  durations.reserve(sample_table.size());
+  frame_indices.reserve(sample_table.size());
 
   for (unsigned int frame = 0, num_samples = sample_table.size(); num_samples > frame; ++frame) {
     int64_t pts_offset = 0;
@@ -1734,7 +1851,21 @@ qtmp4_demuxer_c::calculate_timecodes_variable_sample_size() {
 
     frame_indices.push_back(real_frame);
 
-    timecodes_before_offsets.push_back(timecode);
+    // A frame's duration is the difference to the following frame's
+    // timecode before the CTS offsets are applied.
+    if (frame) {
+      int64_t diff = timecode - previous_timecode;
+
+      if (0 >= diff)
+        durations.push_back(0);
+      else {
+        ++num_good_frames;
+        avg_duration += diff;
+        durations.push_back(diff);
+      }
+    }
+
+    previous_timecode = timecode;
 
     if (is_avc && (num_frame_offsets > real_frame))
        timecode += to_nsecs(frame_offset_table[real_frame]) - v_dts_offset;
@@ -1742,21 +1873,8 @@ qtmp4_demuxer_c::calculate_timecodes_variable_sample_size() {
     timecodes.push_back(timecode + constant_editlist_offset_ns);
   }
 
-  int64_t avg_duration = 0, num_good_frames = 0;
-
-  for (unsigned int frame = 0, num_timecodes_before_offsets = timecodes_before_offsets.size(); num_timecodes_before_offsets > (frame + 1); ++frame) {
-    int64_t diff = timecodes_before_offsets[frame + 1] - timecodes_before_offsets[frame];
-
-    if (0 >= diff)
-      durations.push_back(0);
-    else {
-      ++num_good_frames;
-      avg_duration += diff;
-      durations.push_back(diff);
-    }
-  }
-
-  durations.push_back(0);
+  if (!timecodes.empty())
+    durations.push_back(0);
 
   if (num_good_frames) {
     avg_duration /= num_good_frames;
@@ -1793,6 +1911,20 @@ qtmp4_demuxer_c::update_tables(int64_t global_m_time_scale) {
   if (!last)
     return false;
 
+  // Constant sample size with variable durations is not supported. This
+  // must be checked before the shortcut for identification below, or
+  // files would be identified as supported that cannot be muxed.
+  auto constant_sample_size = sample_table.empty() && (1 >= sample_size);
+  if (   constant_sample_size
+      && !((1 == durmap_table.size()) || ((2 == durmap_table.size()) && (1 == durmap_table[1].number))))
+    mxerror(Y("Quicktime/MP4 reader: Constant samplesize & variable duration not yet supported. Contact the author if you have such a sample file.\n"));
+
+  // Expanding the tables into per-sample positions and timestamps is
+  // only needed for reading frames. When identifying, only the
+  // chapter track's samples have to be read.
+  if (g_identifying && !is_chapters())
+    return true;
+
   // process chunkmap:
   size_t j, i = chunkmap_table.size();
   while (i > 0) {
@@ -1828,13 +1960,8 @@ qtmp4_demuxer_c::update_tables(int64_t global_m_time_scale) {
     sample_size = 0;
   }
 
-  if (sample_table.empty()) {
-    // constant samplesize
-    if ((1 == durmap_table.size()) || ((2 == durmap_table.size()) && (1 == durmap_table[1].number)))
-      duration = durmap_table[0].duration;
-    else
-      mxerror(Y("Quicktime/MP4 reader: Constant samplesize & variable duration not yet supported. Contact the author if you have such a sample file.\n"));
-
+  if (constant_sample_size) {
+    duration = durmap_table[0].duration;
     return true;
   }
 
@@ -1976,6 +2103,8 @@ qtmp4_demuxer_c::build_index_constant_sample_size_mode() {
   size_t keyframe_table_idx  = 0;
   size_t keyframe_table_size = keyframe_table.size();
 
+  m_index.reserve(chunk_table.size());
+
   size_t frame_idx;
   for (frame_idx = 0; frame_idx < chunk_table.size(); ++frame_idx) {
     uint64_t frame_size;
@@ -2013,6 +2142,8 @@ qtmp4_demuxer_c::build_index_chunk_mode() {
   size_t keyframe_table_idx  = 0;
   size_t keyframe_table_size = keyframe_table.size();
 
+  m_index.reserve(frame_indices.size());
+
   size_t frame_idx;
   for (frame_idx = 0; frame_idx < frame_indices.size(); ++frame_idx) {
     int act_frame_idx = frame_indices[frame_idx];
@@ -2029,6 +2160,24 @@ qtmp4_demuxer_c::build_index_chunk_mode() {
   }
 }
 
+void
+qtmp4_demuxer_c::release_tables() {
+  // Once the index has been built the per-sample tables are not needed
+  // anymore. For long recordings they take up several times as much
+  // memory as the index itself. The run-length coded frame offset table
+  // is kept as it's small and still consulted when creating the
+  // packetizers.
+  std::vector<qt_sample_t>{}.swap(sample_table);
+  std::vector<qt_chunk_t>{}.swap(chunk_table);
+  std::vector<qt_chunkmap_t>{}.swap(chunkmap_table);
+  std::vector<qt_durmap_t>{}.swap(durmap_table);
+  std::vector<uint32_t>{}.swap(keyframe_table);
+  std::vector<int32_t>{}.swap(frame_offset_table);
+  std::vector<int64_t>{}.swap(timecodes);
+  std::vector<int64_t>{}.swap(durations);
+  std::vector<int64_t>{}.swap(frame_indices);
+}
+
 bool
 qtmp4_demuxer_c::read_first_bytes(memory_cptr &buf,
                                   int num_bytes,
@@ -2038,7 +2187,7 @@ qtmp4_demuxer_c::read_first_bytes(memory_cptr &buf,
 
   while ((0 < num_bytes) && (idx_pos < m_index.size())) {
     qt_index_t &index          = m_index[idx_pos];
-    uint64_t num_bytes_to_read = std::min((int64_t)num_bytes, index.size);
+    uint64_t num_bytes_to_read = std::min<int64_t>(num_bytes, index.size);
 
     in->setFilePointer(index.file_pos);
     if (in->read(buf->get_buffer() + buf_pos, num_bytes_to_read) < num_bytes_to_read)
@@ -232,6 +232,7 @@ struct qtmp4_demuxer_c {
   void update_editlist_table(int64_t global_time_scale);
 
   void build_index();
+  void release_tables();
 
   bool read_first_bytes(memory_cptr &buf, int num_bytes, mm_io_cptr in);
 
@@ -340,7 +341,7 @@ private:
 
   unsigned int m_audio_encoder_delay_samples;
 
-  debugging_option_c m_debug_chapters, m_debug_headers, m_debug_tables, m_debug_interleaving, m_debug_resync;
+  debugging_option_c m_debug_chapters, m_debug_headers, m_debug_tables, m_debug_interleaving, m_debug_resync, m_debug_skipping;
 
 public:
   qtmp4_reader_c(const track_info_c &ti, const mm_io_cptr &in);
@@ -352,6 +353,7 @@ public:
 
   virtual void read_headers();
   virtual file_status_e read(generic_packetizer_c *ptzr, bool force = false);
+  virtual bool skip_to_timecode(timecode_c const &timecode);
   virtual int get_progress();
   virtual void identify();
   virtual void create_packetizers();
@@ -364,6 +366,7 @@ protected:
   virtual void parse_headers();
   virtual void calculate_timecodes();
   virtual qt_atom_t read_atom(mm_io_c *read_from = nullptr, bool exit_on_error = true);
+  virtual memory_cptr read_table_entries(qt_atom_t const &atom, uint32_t &num_entries, size_t entry_size);
   virtual bool resync_to_top_level_atom(uint64_t start_pos);
   virtual void parse_itunsmpb(std::string data);
 
@@ -418,47 +418,97 @@ real_reader_c::finish() {
   return flush_packetizers();
 }
 
+bool
+real_reader_c::read_next_frame_header(rmff_frame_t &frame) {
+  // Same logic as rmff_read_next_frame() but without its per-frame
+  // allocations: the header is parsed here, and the caller decides where
+  // the payload is read to.
+  unsigned char header[12];
+
+  while (true) {
+    if ((file->size - static_cast<int64_t>(m_in->getFilePointer())) < 12)
+      return false;
+
+    if (m_in->read(header, 12) != 12)
+      return false;
+
+    uint32_t object_id = get_uint32_be(&header[0]);
+    if (rmffFOURCC('D', 'A', 'T', 'A') == object_id) {
+      file->num_packets_in_chunk = get_uint32_be(&header[4]);
+      file->num_packets_read     = 0;
+      continue;
+    }
+
+    if ((file->num_packets_read >= file->num_packets_in_chunk) || (rmffFOURCC('I', 'N', 'D', 'X') == object_id))
+      return false;
+
+    unsigned int length = get_uint16_be(&header[2]);
+    if ((12 >= length) || ((file->size - static_cast<int64_t>(m_in->getFilePointer())) < (length - 12)))
+      return false;
+
+    memset(&frame, 0, sizeof(rmff_frame_t));
+    frame.size     = length - 12;
+    frame.id       = get_uint16_be(&header[4]);
+    frame.timecode = get_uint32_be(&header[6]);
+    frame.reserved = header[10];
+    frame.flags    = header[11];
+
+    return true;
+  }
+}
+
 file_status_e
 real_reader_c::read(generic_packetizer_c *,
                     bool) {
   if (done)
     return flush_packetizers();
 
-  int size = rmff_get_next_frame_size(file);
-  if (0 >= size) {
+  rmff_frame_t frame;
+  if (!read_next_frame_header(frame)) {
     if (file->num_packets_read < file->num_packets_in_chunk)
       mxwarn_fn(m_ti.m_fname, boost::format(Y("File contains fewer frames than expected or is corrupt after frame %1%.\n")) % file->num_packets_read);
     return finish();
   }
 
-  memory_c mem(size);
-  rmff_frame_t *frame = rmff_read_next_frame(file, mem.get_buffer());
+  real_demuxer_cptr dmx = find_demuxer(frame.id);
 
-  if (!frame) {
-    if (file->num_packets_read < file->num_packets_in_chunk)
-      mxwarn_fn(m_ti.m_fname, boost::format(Y("File contains fewer frames than expected or is corrupt after frame %1%.\n")) % file->num_packets_read);
-    return finish();
+  if (!dmx || (-1 == dmx->ptzr)) {
+    m_in->skip(frame.size);
+    ++file->num_packets_read;
+    return FILE_STATUS_MOREDATA;
   }
 
-  int64_t timecode      = (int64_t)frame->timecode * 1000000ll;
-  real_demuxer_cptr dmx = find_demuxer(frame->id);
+  // Queued audio frames are kept until the next timecode is
+  // known. Everything else is consumed before read() returns and can be
+  // read into the frame buffer re-used for all packets.
+  bool queue_frame = (RMFF_TRACK_TYPE_VIDEO != dmx->track->type) && !dmx->is_aac;
 
-  if (!dmx || (-1 == dmx->ptzr)) {
-    rmff_release_frame(frame);
-    return FILE_STATUS_MOREDATA;
+  if (!queue_frame && (!m_frame_buffer || (m_frame_buffer->get_size() < frame.size)))
+    m_frame_buffer = memory_c::alloc(frame.size);
+
+  memory_c mem = queue_frame ? memory_c(frame.size) : memory_c(m_frame_buffer->get_buffer(), frame.size, false);
+
+  if (m_in->read(mem.get_buffer(), frame.size) != frame.size) {
+    mxwarn_fn(m_ti.m_fname, boost::format(Y("File contains fewer frames than expected or is corrupt after frame %1%.\n")) % file->num_packets_read);
+    return finish();
   }
 
-  if (dmx->cook_audio_fix && dmx->first_frame && ((frame->flags & RMFF_FRAME_FLAG_KEYFRAME) != RMFF_FRAME_FLAG_KEYFRAME))
+  frame.data = mem.get_buffer();
+  ++file->num_packets_read;
+
+  int64_t timecode = (int64_t)frame.timecode * 1000000ll;
+
+  if (dmx->cook_audio_fix && dmx->first_frame && ((frame.flags & RMFF_FRAME_FLAG_KEYFRAME) != RMFF_FRAME_FLAG_KEYFRAME))
     dmx->force_keyframe_flag = true;
 
-  if (dmx->force_keyframe_flag && ((frame->flags & RMFF_FRAME_FLAG_KEYFRAME) == RMFF_FRAME_FLAG_KEYFRAME))
+  if (dmx->force_keyframe_flag && ((frame.flags & RMFF_FRAME_FLAG_KEYFRAME) == RMFF_FRAME_FLAG_KEYFRAME))
     dmx->force_keyframe_flag = false;
 
   if (dmx->force_keyframe_flag)
-    frame->flags |= RMFF_FRAME_FLAG_KEYFRAME;
+    frame.flags |= RMFF_FRAME_FLAG_KEYFRAME;
 
   if (RMFF_TRACK_TYPE_VIDEO == dmx->track->type)
-    assemble_video_packet(dmx, frame);
+    assemble_video_packet(dmx, &frame);
 
   else if (dmx->is_aac) {
     // If the first AAC packet does not start at 0 then let the AAC
@@ -471,9 +521,7 @@ real_reader_c::read(generic_packetizer_c *,
     deliver_aac_frames(dmx, mem);
 
   } else
-    queue_audio_frames(dmx, mem, timecode, frame->flags);
-
-  rmff_release_frame(frame);
+    queue_audio_frames(dmx, mem, timecode, frame.flags);
 
   dmx->first_frame = false;
 
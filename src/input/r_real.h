@@ -90,6 +90,7 @@ private:
   rmff_file_t *file;
   std::vector<std::shared_ptr<real_demuxer_t> > demuxers;
   bool done;
+  memory_cptr m_frame_buffer;
 
 public:
   real_reader_c(const track_info_c &ti, const mm_io_cptr &in);
@@ -112,6 +113,7 @@ public:
 protected:
   virtual void parse_headers();
   virtual real_demuxer_cptr find_demuxer(unsigned int id);
+  virtual bool read_next_frame_header(rmff_frame_t &frame);
   virtual void assemble_video_packet(real_demuxer_cptr dmx, rmff_frame_t *frame);
   virtual file_status_e finish();
   virtual bool get_rv_dimensions(unsigned char *buf, int size, uint32_t &width, uint32_t &height);
@@ -18,6 +18,7 @@
 #include "common/iso639.h"
 #include "common/endian.h"
 #include "common/mm_io.h"
+#include "common/mm_read_buffer_io.h"
 #include "common/strings/formatting.h"
 #include "common/strings/parsing.h"
 #include "input/r_vobsub.h"
@@ -64,6 +65,8 @@ vobsub_reader_c::vobsub_reader_c(const track_info_c &ti,
                                  const mm_io_cptr &in)
   : generic_reader_c(ti, in)
   , delay(0)
+  , m_schedule_pos(0)
+  , m_schedule_built(false)
 {
 }
 
@@ -82,7 +85,7 @@ vobsub_reader_c::read_headers() {
   sub_name += ".sub";
 
   try {
-    m_sub_file = mm_file_io_cptr(new mm_file_io_c(sub_name));
+    m_sub_file = mm_io_cptr(new mm_read_buffer_io_c(new mm_file_io_c(sub_name), 1 << 20));
   } catch (...) {
     throw mtx::input::extended_x(boost::format(Y("%1%: Could not open the sub file")) % get_format_name());
   }
@@ -331,7 +334,70 @@ vobsub_reader_c::parse_headers() {
   }
 }
 
-#define deliver() deliver_packet(dst_buf, dst_size, timecode, duration, PTZR(track->ptzr));
+/** \brief Order the extraction of all tracks' SPU packets
+
+   The entries of all tracks with packetizers are merged into one list
+   sorted by their position in the .sub file. Each track's own entries
+   keep their order. Extracting packets in this order reads the .sub
+   file front to back instead of jumping between the tracks'
+   positions.
+*/
+void
+vobsub_reader_c::build_schedule() {
+  m_schedule_built = true;
+
+  std::vector<unsigned int> next_entry(tracks.size(), 0);
+
+  while (true) {
+    auto best_track = tracks.size();
+
+    for (size_t id = 0; id < tracks.size(); ++id) {
+      auto track = tracks[id];
+      if ((-1 == track->ptzr) || (next_entry[id] >= track->entries.size()))
+        continue;
+
+      if (   (tracks.size() == best_track)
+          || (track->entries[next_entry[id]].position < tracks[best_track]->entries[next_entry[best_track]].position))
+        best_track = id;
+    }
+
+    if (tracks.size() == best_track)
+      break;
+
+    m_schedule.emplace_back(best_track, next_entry[best_track]);
+    ++next_entry[best_track];
+  }
+
+  mxverb(3, boost::format("vobsub_reader: extraction schedule contains %1% entries\n") % m_schedule.size());
+}
+
+void
+vobsub_reader_c::extract_scheduled_spu_packets(size_t track_id,
+                                               unsigned int entry_idx) {
+  if (!m_schedule_built)
+    build_schedule();
+
+  auto track = tracks[track_id];
+
+  while (!track->extracted.count(entry_idx) && (m_schedule_pos < m_schedule.size())) {
+    auto const &item = m_schedule[m_schedule_pos++];
+    extract_one_spu_packet(item.first, item.second);
+  }
+
+  if (!track->extracted.count(entry_idx))
+    extract_one_spu_packet(track_id, entry_idx);
+}
+
+int
+vobsub_reader_c::store_spu_packet(vobsub_track_c *track,
+                                  unsigned int entry_idx,
+                                  unsigned char *buf,
+                                  uint32_t size) {
+  track->extracted[entry_idx] = std::make_pair(buf, size);
+  return -1;
+}
+
+#define deliver() store_spu_packet(track, entry_idx, dst_buf, dst_size);
 int
 vobsub_reader_c::deliver_packet(unsigned char *buf,
                                 int size,
@@ -417,7 +483,8 @@ vobsub_reader_c::deliver_packet(unsigned char *buf,
 
 // Adopted from mplayer's vobsub.c
 int
-vobsub_reader_c::extract_one_spu_packet(int64_t track_id) {
+vobsub_reader_c::extract_one_spu_packet(int64_t track_id,
+                                        unsigned int entry_idx) {
   uint32_t len, idx, mpeg_version;
   int c, packet_aid;
   /* Goto start of a packet, it starts with 0x000001?? */
@@ -425,10 +492,9 @@ vobsub_reader_c::extract_one_spu_packet(int64_t track_id) {
   unsigned char buf[5];
 
   vobsub_track_c *track         = tracks[track_id];
-  int64_t timecode              = track->entries[track->idx].timestamp;
-  int64_t duration              = track->entries[track->idx].duration;
-  uint64_t extraction_start_pos = track->entries[track->idx].position;
-  uint64_t extraction_end_pos   = track->idx >= track->entries.size() - 1 ? m_sub_file->get_size() : track->entries[track->idx + 1].position;
+  int64_t timecode              = track->entries[entry_idx].timestamp;
+  uint64_t extraction_start_pos = track->entries[entry_idx].position;
+  uint64_t extraction_end_pos   = entry_idx >= track->entries.size() - 1 ? m_sub_file->get_size() : track->entries[entry_idx + 1].position;
 
   int64_t pts                   = 0;
   unsigned char *dst_buf        = nullptr;
@@ -634,7 +700,14 @@ vobsub_reader_c::read(generic_packetizer_c *ptzr,
   if (track->idx >= track->entries.size())
     return flush_packetizers();
 
-  extract_one_spu_packet(id);
+  extract_scheduled_spu_packets(id, track->idx);
+
+  auto &entry = track->entries[track->idx];
+  auto spu    = track->extracted[track->idx];
+  track->extracted.erase(track->idx);
+
+  deliver_packet(spu.first, spu.second, entry.timestamp, entry.duration, PTZR(track->ptzr));
+
   track->idx++;
   indices_processed++;
 
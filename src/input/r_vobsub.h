@@ -41,6 +41,10 @@ public:
   bool mpeg_version_warning_printed;
   int64_t packet_num, spu_size, overhead;
 
+  // SPU packets that have been extracted ahead of time, indexed by
+  // their entry number. The buffers are allocated with saferealloc().
+  std::map<unsigned int, std::pair<unsigned char *, uint32_t> > extracted;
+
 public:
   vobsub_track_c(const std::string &new_language):
     language(new_language),
@@ -52,18 +56,29 @@ public:
     spu_size(0),
     overhead(0) {
   }
+
+  ~vobsub_track_c() {
+    for (auto &spu : extracted)
+      safefree(spu.second.first);
+  }
 };
 
 class vobsub_reader_c: public generic_reader_c {
 private:
   mm_text_io_cptr m_idx_file;
-  mm_file_io_cptr m_sub_file;
+  mm_io_cptr m_sub_file;
   int version;
   int64_t num_indices, indices_processed, delay;
   std::string idx_data;
 
   std::vector<vobsub_track_c *> tracks;
 
+  // All entries of all tracks with packetizers sorted by their
+  // position in the .sub file; pairs of track ID and entry number.
+  std::vector<std::pair<size_t, unsigned int> > m_schedule;
+  size_t m_schedule_pos;
+  bool m_schedule_built;
+
 private:
   static const std::string id_string;
 
@@ -93,7 +108,10 @@ protected:
   virtual file_status_e flush_packetizers();
   virtual int deliver_packet(unsigned char *buf, int size, int64_t timecode, int64_t default_duration, generic_packetizer_c *ptzr);
 
-  virtual int extract_one_spu_packet(int64_t track_id);
+  virtual void build_schedule();
+  virtual void extract_scheduled_spu_packets(size_t track_id, unsigned int entry_idx);
+  virtual int extract_one_spu_packet(int64_t track_id, unsigned int entry_idx);
+  virtual int store_spu_packet(vobsub_track_c *track, unsigned int entry_idx, unsigned char *buf, uint32_t size);
 };
 
 #endif  // MTX_R_VOBSUB_H
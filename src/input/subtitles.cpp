@@ -85,7 +85,6 @@ srt_parser_c::srt_parser_c(mm_text_io_c *io,
 void
 srt_parser_c::parse() {
   boost::regex timecode_re(SRT_RE_TIMECODE_LINE, boost::regex::perl);
-  boost::regex number_re("^\\d+$", boost::regex::perl);
   boost::regex coordinates_re(SRT_RE_COORDINATES, boost::regex::perl);
 
   int64_t start                 = 0;
@@ -98,13 +97,13 @@ srt_parser_c::parse() {
   unsigned int timecode_number  = 0;
   std::string subtitles;
 
-  m_io->setFilePointer(0, seek_beginning);
+  auto is_number = [](std::string const &s) -> bool {
+    return !s.empty() && (s.end() == std::find_if(s.begin(), s.end(), [](char c) { return ('0' > c) || ('9' < c); }));
+  };
 
-  while (1) {
-    std::string s;
-    if (!m_io->getline2(s))
-      break;
+  m_io->setFilePointer(0, seek_beginning);
 
+  for (auto &s : m_io->getlines()) {
     line_number++;
     strip_back(s);
 
@@ -121,7 +120,7 @@ srt_parser_c::parse() {
     }
 
     if (STATE_INITIAL == state) {
-      if (!boost::regex_match(s, number_re)) {
+      if (!is_number(s)) {
         mxwarn_tid(m_file_name, m_tid, boost::format(Y("Error in line %1%: expected subtitle number and found some text.\n")) % line_number);
         break;
       }
@@ -222,7 +221,7 @@ srt_parser_c::parse() {
         subtitles += "\n";
       subtitles += s;
 
-    } else if (boost::regex_match(s, number_re)) {
+    } else if (is_number(s)) {
       state = STATE_TIME;
       parse_number(s, subtitle_number);
 
@@ -287,6 +286,7 @@ ssa_parser_c::ssa_parser_c(generic_reader_c *reader,
   , m_file_name(file_name)
   , m_tid(tid)
   , m_cc_utf8(charset_converter_c::init("UTF-8"))
+  , m_field_indexes(fi_max, -1)
   , m_is_ass(false)
   , m_attachment_id(0)
 {
@@ -306,39 +306,41 @@ ssa_parser_c::parse() {
   ssa_section_e previous_section = SSA_SECTION_NONE;
   std::string name_field         = "Name";
 
-  std::string attachment_name, attachment_data_uu;
+  std::string attachment_name, attachment_data_uu, recoded;
+  std::vector<std::pair<size_t, size_t> > fields;
 
   m_io->setFilePointer(0, seek_beginning);
 
-  while (!m_io->eof()) {
-    std::string line;
-    if (!m_io->getline2(line))
-      break;
-
+  for (auto &line : m_io->getlines()) {
     bool add_to_global = true;
 
+    // Section headers are the only lines starting with '['. Spare all
+    // other lines the regular expressions.
+    auto first_char    = line.find_first_not_of(" \t\n\v\f\r");
+    auto maybe_section = (std::string::npos != first_char) && ('[' == line[first_char]);
+
     // A normal line. Let's see if this file is ASS and not SSA.
     if (!strcasecmp(line.c_str(), "ScriptType: v4.00+"))
       m_is_ass = true;
 
-    else if (boost::regex_search(line, sec_styles_ass_re)) {
+    else if (maybe_section && boost::regex_search(line, sec_styles_ass_re)) {
       m_is_ass = true;
       section  = SSA_SECTION_V4STYLES;
 
-    } else if (boost::regex_search(line, sec_styles_re))
+    } else if (maybe_section && boost::regex_search(line, sec_styles_re))
       section = SSA_SECTION_V4STYLES;
 
-    else if (boost::regex_search(line, sec_info_re))
+    else if (maybe_section && boost::regex_search(line, sec_info_re))
       section = SSA_SECTION_INFO;
 
-    else if (boost::regex_search(line, sec_events_re))
+    else if (maybe_section && boost::regex_search(line, sec_events_re))
       section = SSA_SECTION_EVENTS;
 
-    else if (boost::regex_search(line, sec_graphics_re)) {
+    else if (maybe_section && boost::regex_search(line, sec_graphics_re)) {
       section       = SSA_SECTION_GRAPHICS;
       add_to_global = false;
 
-    } else if (boost::regex_search(line, sec_fonts_re)) {
+    } else if (maybe_section && boost::regex_search(line, sec_fonts_re)) {
       section       = SSA_SECTION_FONTS;
       add_to_global = false;
 
@@ -356,37 +358,36 @@ ssa_parser_c::parse() {
             break;
           }
 
+        update_field_indexes(name_field);
+
       } else if (balg::istarts_with(line, "Dialogue: ")) {
         if (m_format.empty())
           throw mtx::input::extended_x(Y("ssa_reader: Invalid format. Could not find the \"Format\" line in the \"[Events]\" section."));
 
-        std::string orig_line = line;
-
-        line.erase(0, strlen("Dialogue: ")); // Trim the start.
+        // Split the line into fields. The last field (usually the
+        // text) contains the rest of the line including any commas.
+        split_fields(line, strlen("Dialogue: "), fields);
 
-        // Split the line into fields.
-        std::vector<std::string> fields = split(line.c_str(), ",", m_format.size());
-        while (fields.size() < m_format.size())
-          fields.push_back(std::string(""));
+        auto field = [&line, &fields](int idx) -> std::string {
+          return (0 <= idx) && (static_cast<size_t>(idx) < fields.size()) ? line.substr(fields[idx].first, fields[idx].second) : std::string{};
+        };
 
         // Parse the start time.
-        std::string stime = get_element("Start", fields);
-        int64_t start     = parse_time(stime);
+        int64_t start = parse_time(field(m_field_indexes[fi_start]));
         if (0 > start) {
-          mxwarn_tid(m_file_name, m_tid, boost::format(Y("Malformed line? (%1%)\n")) % orig_line);
+          mxwarn_tid(m_file_name, m_tid, boost::format(Y("Malformed line? (%1%)\n")) % line);
           continue;
         }
 
         // Parse the end time.
-        stime       = get_element("End", fields);
-        int64_t end = parse_time(stime);
+        int64_t end = parse_time(field(m_field_indexes[fi_end]));
         if (0 > end) {
-          mxwarn_tid(m_file_name, m_tid, boost::format(Y("Malformed line? (%1%)\n")) % orig_line);
+          mxwarn_tid(m_file_name, m_tid, boost::format(Y("Malformed line? (%1%)\n")) % line);
           continue;
         }
 
         if (end < start) {
-          mxwarn_tid(m_file_name, m_tid, boost::format(Y("Malformed line? (%1%)\n")) % orig_line);
+          mxwarn_tid(m_file_name, m_tid, boost::format(Y("Malformed line? (%1%)\n")) % line);
           continue;
         }
 
@@ -394,19 +395,23 @@ ssa_parser_c::parse() {
         // ReadOrder, Layer, Style, Name, MarginL, MarginR, MarginV, Effect,
         //   Text
 
-        std::string comma = ",";
-        line
-          = to_string(num)                          + comma
-          + get_element("Layer", fields)            + comma
-          + get_element("Style", fields)            + comma
-          + get_element(name_field.c_str(), fields) + comma
-          + get_element("MarginL", fields)          + comma
-          + get_element("MarginR", fields)          + comma
-          + get_element("MarginV", fields)          + comma
-          + get_element("Effect", fields)           + comma
-          + recode_text(fields);
-
-        add(start, end, num, line);
+        auto text = m_cc_utf8->utf8(field(m_field_indexes[fi_text]));
+
+        recoded.clear();
+        recoded.reserve(line.size() + 16);
+        recoded += to_string(num);
+
+        for (auto field_index : { fi_layer, fi_style, fi_name, fi_margin_l, fi_margin_r, fi_margin_v, fi_effect }) {
+          recoded += ',';
+          auto idx = m_field_indexes[field_index];
+          if ((0 <= idx) && (static_cast<size_t>(idx) < fields.size()))
+            recoded.append(line, fields[idx].first, fields[idx].second);
+        }
+
+        recoded += ',';
+        recoded += text;
+
+        add(start, end, num, recoded);
         num++;
 
         add_to_global = false;
@@ -442,60 +447,60 @@ ssa_parser_c::parse() {
   sort();
 }
 
-std::string
-ssa_parser_c::get_element(const char *index,
-                          std::vector<std::string> &fields) {
-  size_t i;
-
-  for (i = 0; i < m_format.size(); i++)
-    if (m_format[i] == index)
-      return fields[i];
+void
+ssa_parser_c::update_field_indexes(std::string const &name_field) {
+  static char const * const s_names[] = { "Start", "End", "Layer", "Style", nullptr, "MarginL", "MarginR", "MarginV", "Effect", "Text" };
 
-  return std::string("");
+  for (auto field_index = 0u; fi_max > field_index; ++field_index) {
+    auto name                     = s_names[field_index] ? std::string{s_names[field_index]} : name_field;
+    auto itr                      = brng::find(m_format, name);
+    m_field_indexes[field_index] = m_format.end() == itr ? -1 : std::distance(m_format.begin(), itr);
+  }
 }
 
-int64_t
-ssa_parser_c::parse_time(std::string &stime) {
-  int64_t th, tm, ts, tds;
+void
+ssa_parser_c::split_fields(std::string const &line,
+                           size_t start,
+                           std::vector<std::pair<size_t, size_t> > &fields) {
+  fields.clear();
+
+  while (fields.size() + 1 < m_format.size()) {
+    auto comma = line.find(',', start);
+    if (std::string::npos == comma)
+      break;
 
-  int pos = stime.find(':');
-  if (0 > pos)
-    return -1;
+    fields.emplace_back(start, comma - start);
+    start = comma + 1;
+  }
 
-  std::string s = stime.substr(0, pos);
-  if (!parse_number(s, th))
-    return -1;
-  stime.erase(0, pos + 1);
+  fields.emplace_back(start, line.size() - start);
+}
 
-  pos = stime.find(':');
-  if (0 > pos)
-    return -1;
+int64_t
+ssa_parser_c::parse_time(std::string const &stime) {
+  int64_t th, tm, ts, tds;
 
-  s = stime.substr(0, pos);
-  if (!parse_number(s, tm))
+  auto first_colon = stime.find(':');
+  if (std::string::npos == first_colon)
     return -1;
-  stime.erase(0, pos + 1);
 
-  pos = stime.find('.');
-  if (0 > pos)
+  auto second_colon = stime.find(':', first_colon + 1);
+  if (std::string::npos == second_colon)
     return -1;
 
-  s = stime.substr(0, pos);
-  if (!parse_number(s, ts))
+  auto dot = stime.find('.', second_colon + 1);
+  if (std::string::npos == dot)
     return -1;
-  stime.erase(0, pos + 1);
 
-  if (!parse_number(stime, tds))
+  if (   !parse_number(stime.substr(0,                first_colon),                     th)
+      || !parse_number(stime.substr(first_colon  + 1, second_colon - first_colon  - 1), tm)
+      || !parse_number(stime.substr(second_colon + 1, dot          - second_colon - 1), ts)
+      || !parse_number(stime.substr(dot          + 1),                                  tds))
     return -1;
 
   return (tds * 10 + ts * 1000 + tm * 60 * 1000 + th * 60 * 60 * 1000) * 1000000;
 }
 
-std::string
-ssa_parser_c::recode_text(std::vector<std::string> &fields) {
-  return m_cc_utf8->utf8(get_element("Text", fields));
-}
-
 void
 ssa_parser_c::add_attachment_maybe(std::string &name,
                                    std::string &data_uu,
@@ -537,8 +542,17 @@ ssa_parser_c::add_attachment_maybe(std::string &name,
   auto out                = attachment.data->get_buffer();
   auto in                 = reinterpret_cast<unsigned char const *>(data_uu.c_str());
 
-  for (auto end = in + (data_uu.length() / 4) * 4; in < end; in += 4, out += 3)
-    decode_chars(in, out, 4);
+  // Full groups are decoded inline; only the trailing partial group
+  // needs the generic version.
+  for (auto end = in + (data_uu.length() / 4) * 4; in < end; in += 4, out += 3) {
+    auto value = ((static_cast<uint32_t>(in[0]) - 33) << 18)
+               | ((static_cast<uint32_t>(in[1]) - 33) << 12)
+               | ((static_cast<uint32_t>(in[2]) - 33) <<  6)
+               |  (static_cast<uint32_t>(in[3]) - 33);
+    out[0]     = (value >> 16) & 0xff;
+    out[1]     = (value >>  8) & 0xff;
+    out[2]     =  value        & 0xff;
+  }
 
   decode_chars(in, out, data_uu.length() % 4);
 
@@ -100,6 +100,21 @@ public:
     SSA_SECTION_FONTS
   };
 
+  // Fields copied from "Dialogue:" lines; indexes into m_field_indexes.
+  enum ssa_field_e {
+    fi_start,
+    fi_end,
+    fi_layer,
+    fi_style,
+    fi_name,
+    fi_margin_l,
+    fi_margin_r,
+    fi_margin_v,
+    fi_effect,
+    fi_text,
+    fi_max
+  };
+
 protected:
   generic_reader_c *m_reader;
   mm_text_io_c *m_io;
@@ -107,6 +122,7 @@ protected:
   int64_t m_tid;
   charset_converter_cptr m_cc_utf8;
   std::vector<std::string> m_format;
+  std::vector<int> m_field_indexes;
   bool m_is_ass;
   std::string m_global;
   int64_t m_attachment_id;
@@ -138,9 +154,9 @@ public:
   static bool probe(mm_text_io_c *io);
 
 protected:
-  int64_t parse_time(std::string &time);
-  std::string get_element(const char *index, std::vector<std::string> &fields);
-  std::string recode_text(std::vector<std::string> &fields);
+  int64_t parse_time(std::string const &time);
+  void update_field_indexes(std::string const &name_field);
+  void split_fields(std::string const &line, size_t start, std::vector<std::pair<size_t, size_t> > &fields);
   void add_attachment_maybe(std::string &name, std::string &data_uu, ssa_section_e section);
   void decode_chars(unsigned char const *in, unsigned char *out, size_t bytes_in);
 };
@@ -211,6 +211,22 @@ cluster_helper_c::split(packet_cptr &packet) {
   handle_discarded_duration(create_new_file, previously_discarding);
 
   prepare_new_cluster();
+
+  skip_discarded_range();
+}
+
+void
+cluster_helper_c::skip_discarded_range() {
+  // Only possible for timecode based parts. Frame/field based parts
+  // require every single frame to be counted.
+  if (   !discarding()
+      || (m_split_points.end() == m_current_split_point)
+      || (split_point_c::parts != m_current_split_point->m_type))
+    return;
+
+  mxdebug_if(m_debug_splitting, boost::format("Splitting: letting readers skip ahead to %1%\n") % format_timecode(m_current_split_point->m_point));
+
+  skip_readers_to_timecode(timecode_c::ns(m_current_split_point->m_point));
 }
 
 void
@@ -108,6 +108,7 @@ public:
   }
 
   void discard_queued_packets();
+  void skip_discarded_range();
   bool is_splitting_and_processed_fully() const {
     return m_splitting_and_processed_fully;
   }
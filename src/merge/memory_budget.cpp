@@ -0,0 +1,152 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   the global budget for queued packets
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include "common/fs_sys_helpers.h"
+#include "common/mm_io.h"
+#include "common/random.h"
+#include "merge/memory_budget.h"
+#include "merge/packet.h"
+
+int64_t memory_budget_c::ms_max_bytes          = 0;
+int64_t memory_budget_c::ms_queued_bytes       = 0;
+int64_t memory_budget_c::ms_peak_queued_bytes  = 0;
+int64_t memory_budget_c::ms_spilled_bytes      = 0;
+int64_t memory_budget_c::ms_peak_spilled_bytes = 0;
+
+namespace {
+
+/* The temporary file spilled packets are written to. It is only
+   created once the first packet has to be spilled and removed again
+   when mkvmerge exits, no matter how. */
+class spill_file_c {
+protected:
+  bfs::path m_file_name;
+  mm_io_cptr m_file;
+  int64_t m_end;
+
+public:
+  spill_file_c()
+    : m_end{}
+  {
+  }
+
+  ~spill_file_c() {
+    if (!m_file)
+      return;
+
+    m_file.reset();
+
+    boost::system::error_code ec;
+    bfs::remove(m_file_name, ec);
+  }
+
+  mm_io_c &get() {
+    if (!m_file) {
+      m_file_name = bfs::temp_directory_path() / (boost::format("mkvmerge-spill-%1%-%2$08x.tmp") % get_current_time_millis() % random_c::generate_32bits()).str();
+
+      try {
+        m_file = mm_io_cptr{new mm_file_io_c{m_file_name.string(), MODE_CREATE}};
+      } catch (mtx::mm_io::exception &ex) {
+        mxerror(boost::format(Y("The temporary file '%1%' for queued data could not be created: %2%\n")) % m_file_name.string() % ex);
+      }
+    }
+
+    return *m_file;
+  }
+
+  int64_t append(memory_c &data) {
+    auto &file     = get();
+    auto position  = m_end;
+
+    try {
+      file.setFilePointer(position);
+      if (file.write(data.get_buffer(), data.get_size()) != data.get_size())
+        throw mtx::mm_io::end_of_file_x{};
+
+    } catch (mtx::mm_io::exception &) {
+      mxerror(boost::format(Y("Could not write to the temporary file '%1%' for queued data. Is there enough free disk space?\n")) % m_file_name.string());
+    }
+
+    m_end += data.get_size();
+
+    return position;
+  }
+
+  memory_cptr read(int64_t position,
+                   int64_t size) {
+    auto &file = get();
+    auto data  = memory_c::alloc(size);
+
+    try {
+      file.setFilePointer(position);
+      if (file.read(data, size) != static_cast<uint64_t>(size))
+        throw mtx::mm_io::end_of_file_x{};
+
+    } catch (mtx::mm_io::exception &) {
+      mxerror(boost::format(Y("Could not read from the temporary file '%1%' for queued data.\n")) % m_file_name.string());
+    }
+
+    return data;
+  }
+
+  // Space is only reused once nothing is spilled anymore. Packets
+  // are restored in roughly the order they've been spilled in so
+  // this happens often enough to keep the file small.
+  void rewind() {
+    m_end = 0;
+  }
+};
+
+spill_file_c s_spill_file;
+
+}
+
+void
+memory_budget_c::spill(packet_t &packet) {
+  auto size                = static_cast<int64_t>(packet.data->get_size());
+  packet.spilled_position  = s_spill_file.append(*packet.data);
+  packet.spilled_size      = size;
+  packet.data.reset();
+
+  ms_spilled_bytes        += size;
+  ms_peak_spilled_bytes    = std::max(ms_peak_spilled_bytes, ms_spilled_bytes);
+  ms_queued_bytes         -= size;
+}
+
+void
+memory_budget_c::restore(packet_t &packet) {
+  auto size     = packet.spilled_size;
+  packet.data   = s_spill_file.read(packet.spilled_position, size);
+
+  forget(packet);
+}
+
+/** \brief Drops the reference to a spilled packet's payload
+
+   The packet's full size is accounted for again so that packetizers
+   can treat spilled and regular packets the same way afterwards.
+*/
+void
+memory_budget_c::forget(packet_t &packet) {
+  auto size                = packet.spilled_size;
+  packet.spilled_position  = -1;
+  packet.spilled_size      = 0;
+
+  ms_spilled_bytes        -= size;
+  account(size);
+
+  if (!ms_spilled_bytes)
+    s_spill_file.rewind();
+}
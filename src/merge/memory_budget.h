@@ -0,0 +1,64 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   definitions for the global budget for queued packets
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_MERGE_MEMORY_BUDGET_H
+#define MTX_MERGE_MEMORY_BUDGET_H
+
+#include "common/common_pch.h"
+
+struct packet_t;
+
+/* Keeps track of the number of bytes queued in all packetizers
+   combined. If a limit has been set with '--max-memory' then the
+   payload of queued packets is moved to a temporary file as long as
+   the total exceeds that limit. Reading and packet selection are not
+   affected at all so that the output is identical with or without
+   a limit. */
+class memory_budget_c {
+protected:
+  static int64_t ms_max_bytes, ms_queued_bytes, ms_peak_queued_bytes, ms_spilled_bytes, ms_peak_spilled_bytes;
+
+public:
+  static void set_max_bytes(int64_t max_bytes) {
+    ms_max_bytes = max_bytes;
+  }
+  static int64_t get_max_bytes() {
+    return ms_max_bytes;
+  }
+  static bool is_limited() {
+    return 0 < ms_max_bytes;
+  }
+  static bool is_exceeded() {
+    return is_limited() && (ms_queued_bytes > ms_max_bytes);
+  }
+
+  static void account(int64_t num_bytes) {
+    ms_queued_bytes      += num_bytes;
+    ms_peak_queued_bytes  = std::max(ms_peak_queued_bytes, ms_queued_bytes);
+  }
+  static int64_t get_queued_bytes() {
+    return ms_queued_bytes;
+  }
+  static int64_t get_peak_queued_bytes() {
+    return ms_peak_queued_bytes;
+  }
+  static int64_t get_peak_spilled_bytes() {
+    return ms_peak_spilled_bytes;
+  }
+
+  static void spill(packet_t &packet);
+  static void restore(packet_t &packet);
+  static void forget(packet_t &packet);
+};
+
+#endif // MTX_MERGE_MEMORY_BUDGET_H
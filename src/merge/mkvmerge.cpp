@@ -28,12 +28,17 @@
 #endif
 #if defined(SYS_WINDOWS)
 #include <windows.h>
+#else
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/wait.h>
 #endif
 
 #include <algorithm>
 #include <iostream>
 #include <list>
 #include <sstream>
+#include <thread>
 #include <tuple>
 #include <typeinfo>
 
@@ -61,6 +66,7 @@
 #include "common/xml/ebml_segmentinfo_converter.h"
 #include "common/xml/ebml_tags_converter.h"
 #include "merge/cluster_helper.h"
+#include "merge/memory_budget.h"
 #include "merge/output_control.h"
 
 using namespace libmatroska;
@@ -109,6 +115,9 @@ set_usage() {
   usage_text += Y("  --disable-lacing         Do not Use lacing.\n");
   usage_text += Y("  --enable-durations       Enable block durations for all blocks.\n");
   usage_text += Y("  --timecode-scale <n>     Force the timecode scale factor to n.\n");
+  usage_text += Y("  --max-memory <d[K,M,G]>  Keep at most d bytes (KB, MB, GB) of data queued\n"
+                  "                           for all tracks in memory and move the rest to a\n"
+                  "                           temporary file.\n");
   usage_text +=   "\n";
   usage_text += Y(" File splitting, linking, appending and concatenating (more global options):\n");
   usage_text += Y("  --split <d[K,M,G]|HH:MM:SS|s>\n"
@@ -257,6 +266,9 @@ set_usage() {
   usage_text +=   "\n\n";
   usage_text += Y(" Other options:\n");
   usage_text += Y("  -i, --identify <file>    Print information about the source file.\n");
+  usage_text += Y("  --identify-server [--identify-verbose|--identify-for-mmg] [--jobs <n>]\n"
+                  "                           Identify all files whose names are read from\n"
+                  "                           stdin, one per line, using up to n processes.\n");
   usage_text += Y("  -l, --list-types         Lists supported input file types.\n");
   usage_text += Y("  --list-languages         Lists all ISO639 languages and their\n"
                   "                           ISO639-2 codes.\n");
@@ -392,6 +404,226 @@ identify(std::string &filename) {
   g_files[0].reader->display_identification_results();
 }
 
+#if !defined(SYS_WINDOWS)
+struct identification_job_t {
+  std::string file_name;
+  bfs::path output_file_name;
+  pid_t pid;
+  int exit_code;
+  bool done;
+};
+
+static int s_child_exited_pipe[2];
+
+static void
+child_exited(int) {
+  auto saved_errno = errno;
+  char c           = 0;
+  if (write(s_child_exited_pipe[1], &c, 1)) {
+  }
+  errno = saved_errno;
+}
+
+static void
+setup_child_exited_notification() {
+  if (pipe(s_child_exited_pipe) != 0)
+    mxerror(boost::format(Y("'--identify-server' could not be set up: %1%\n")) % strerror(errno));
+
+  for (auto fd : s_child_exited_pipe)
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+  struct sigaction action;
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = child_exited;
+  action.sa_flags   = SA_RESTART | SA_NOCLDSTOP;
+  sigemptyset(&action.sa_mask);
+  sigaction(SIGCHLD, &action, nullptr);
+}
+
+/* Runs in the forked process. All output goes to a temporary file that
+   the server copies to stdout once the job is done. mxerror() simply
+   ends this process, so errors cannot affect any other file. */
+static void
+identify_in_child(identification_job_t const &job) {
+  signal(SIGCHLD, SIG_DFL);
+  close(s_child_exited_pipe[0]);
+  close(s_child_exited_pipe[1]);
+
+  try {
+    redirect_stdio(mm_io_cptr{new mm_file_io_c{job.output_file_name.string(), MODE_CREATE}});
+  } catch (mtx::mm_io::exception &) {
+    _exit(2);
+  }
+
+  identify(job.file_name);
+  mxexit();
+}
+
+static void
+start_identification_job(std::deque<identification_job_t> &jobs,
+                         std::string const &file_name) {
+  static auto s_job_number = 0u;
+
+  auto job             = identification_job_t{};
+  job.file_name        = file_name;
+  job.output_file_name = bfs::temp_directory_path() / (boost::format("mkvmerge-identify-%1%-%2%.txt") % getpid() % ++s_job_number).str();
+  job.exit_code        = 2;
+  job.done             = false;
+
+  // Output still buffered would be written a second time by the child.
+  g_mm_stdio->flush();
+  fflush(stdout);
+
+  job.pid = fork();
+  if (0 == job.pid)
+    identify_in_child(job);
+
+  else if (0 > job.pid)
+    mxerror(boost::format(Y("'--identify-server' could not start a new process: %1%\n")) % strerror(errno));
+
+  jobs.push_back(job);
+}
+
+static void
+reap_identification_jobs(std::deque<identification_job_t> &jobs,
+                         unsigned int &num_running) {
+  char buffer[64];
+  while (0 < read(s_child_exited_pipe[0], buffer, sizeof(buffer)))
+    ;
+
+  int status;
+  pid_t pid;
+  while (0 < (pid = waitpid(-1, &status, WNOHANG))) {
+    auto job = brng::find_if(jobs, [pid](identification_job_t const &job) { return job.pid == pid; });
+    if (job == jobs.end())
+      continue;
+
+    job->exit_code = WIFEXITED(status) ? WEXITSTATUS(status) : 2;
+    job->done      = true;
+    --num_running;
+  }
+}
+
+static void
+output_finished_identification_jobs(std::deque<identification_job_t> &jobs) {
+  while (!jobs.empty() && jobs.front().done) {
+    auto &job = jobs.front();
+
+    try {
+      auto content = mm_file_io_c::slurp(job.output_file_name.string());
+      g_mm_stdio->write(content->get_buffer(), content->get_size());
+    } catch (mtx::mm_io::exception &) {
+    }
+
+    boost::system::error_code ec;
+    bfs::remove(job.output_file_name, ec);
+
+    mxinfo(boost::format("--- identify-server done: %1% ---\n") % job.exit_code);
+
+    jobs.pop_front();
+  }
+}
+#endif  // !defined(SYS_WINDOWS)
+
+/** \brief Identify files until stdin is closed
+
+   File names are read from stdin, one per line, and encoded in
+   UTF-8. The identification results for each file are followed by a
+   line '<tt>--- identify-server done: N ---</tt>' with \c N being the
+   exit code a normal '<tt>--identify</tt>' run would have returned.
+   Results are output in the order the file names were read.
+
+   Each file is identified in a process forked off the server. That
+   way the program startup costs are paid only once, up to \c --jobs
+   files are identified concurrently, and errors in one file only end
+   the process identifying it. Identification itself relies on global
+   state (\c g_files, the readers' statics, the message handlers) and
+   could not run in several threads of one process.
+
+   Requires \c fork() and is therefore not available on Windows.
+*/
+static void
+identify_server(std::vector<std::string> const &args) {
+#if defined(SYS_WINDOWS)
+  mxerror(Y("'--identify-server' is not supported on Windows.\n"));
+
+#else  // defined(SYS_WINDOWS)
+  auto max_jobs = std::max(1u, std::thread::hardware_concurrency());
+
+  for (auto arg = args.begin() + 1; arg != args.end(); ++arg) {
+    if ((*arg == "--identify-verbose") || (*arg == "-I"))
+      g_identify_verbose = true;
+
+    else if (*arg == "--identify-for-mmg") {
+      g_identify_verbose = true;
+      g_identify_for_mmg = true;
+
+    } else if (*arg == "--jobs") {
+      ++arg;
+      if ((args.end() == arg) || !parse_number(*arg, max_jobs) || (0 == max_jobs))
+        mxerror(Y("Missing/wrong argument to --jobs\n"));
+
+    } else
+      mxerror(boost::format(Y("Unknown option '%1%' for '--identify-server'.\n")) % *arg);
+  }
+
+  setup_child_exited_notification();
+
+  auto jobs        = std::deque<identification_job_t>{};
+  auto num_running = 0u;
+  auto input       = std::string{};
+  auto input_done  = false;
+
+  while (true) {
+    while (num_running < max_jobs) {
+      auto eol = input.find('\n');
+      if ((std::string::npos == eol) && !(input_done && !input.empty()))
+        break;
+
+      auto line = input.substr(0, eol);
+      input.erase(0, std::string::npos == eol ? eol : eol + 1);
+
+      if (!line.empty() && ('\r' == line[line.length() - 1]))
+        line.erase(line.length() - 1);
+
+      if (!line.empty()) {
+        start_identification_job(jobs, line);
+        ++num_running;
+      }
+    }
+
+    reap_identification_jobs(jobs, num_running);
+    output_finished_identification_jobs(jobs);
+
+    if (input_done && input.empty() && jobs.empty())
+      break;
+
+    // Wait for a job to finish or, if another one may be started, for
+    // more file names. Reading stdin directly instead of via std::cin
+    // keeps front ends that wait for each result before sending the
+    // next name from blocking.
+    pollfd fds[2] = {
+      { s_child_exited_pipe[0], POLLIN, 0 },
+      { 0,                      POLLIN, 0 },
+    };
+    auto read_input = !input_done && (num_running < max_jobs);
+
+    if ((0 > poll(fds, read_input ? 2 : 1, -1)) && (EINTR != errno))
+      mxerror(boost::format(Y("'--identify-server' failed waiting for input: %1%\n")) % strerror(errno));
+
+    if (!read_input || !(fds[1].revents & (POLLIN | POLLHUP | POLLERR)))
+      continue;
+
+    char buffer[4096];
+    auto num_read = read(0, buffer, sizeof(buffer));
+    if (0 < num_read)
+      input.append(buffer, num_read);
+    else if ((0 == num_read) || (EINTR != errno))
+      input_done = true;
+  }
+#endif  // defined(SYS_WINDOWS)
+}
+
 /** \brief Parse a number postfixed with a time-based unit
 
    This function parsers a number that is postfixed with one of the
@@ -1595,6 +1827,43 @@ parse_arg_timecode_scale(const std::string &arg) {
   }
 }
 
+/** \brief Parse the \c --max-memory argument
+
+   The argument is a number optionally followed by one of the size
+   suffixes 'K', 'M' or 'G'.
+*/
+static void
+parse_arg_max_memory(const std::string &arg) {
+  if (memory_budget_c::is_limited())
+    mxerror(Y("'--max-memory' was used more than once.\n"));
+
+  std::string s       = arg;
+  std::string err_msg = Y("Invalid memory limit in '--max-memory %1%'.\n");
+
+  if (s.empty())
+    mxerror(boost::format(err_msg) % arg);
+
+  char mod         = tolower(s[s.length() - 1]);
+  int64_t modifier = 1;
+  if ('k' == mod)
+    modifier = 1024;
+  else if ('m' == mod)
+    modifier = 1024 * 1024;
+  else if ('g' == mod)
+    modifier = 1024 * 1024 * 1024;
+  else if (!isdigit(mod))
+    mxerror(boost::format(err_msg) % arg);
+
+  if (1 != modifier)
+    s.erase(s.size() - 1);
+
+  int64_t max_memory = 0;
+  if (!parse_number(s, max_memory) || (0 >= max_memory))
+    mxerror(boost::format(err_msg) % arg);
+
+  memory_budget_c::set_max_bytes(max_memory * modifier);
+}
+
 static void
 parse_arg_default_language(const std::string &arg) {
   int i = map_to_iso639_2_code(arg.c_str());
@@ -1762,6 +2031,11 @@ parse_common_args(std::vector<std::string> args) {
 
 static void
 parse_args(std::vector<std::string> args) {
+  if (!args.empty() && (args[0] == "--identify-server")) {
+    identify_server(args);
+    mxexit();
+  }
+
   // Check if only information about the file is wanted. In this mode only
   // two parameters are allowed: the --identify switch and the file.
   if ((   (2 == args.size())
@@ -2062,6 +2336,13 @@ parse_args(std::vector<std::string> args) {
 
       parse_arg_timecode_scale(next_arg);
       sit++;
+
+    } else if (this_arg == "--max-memory") {
+      if (no_next_arg)
+        mxerror(Y("'--max-memory' lacks its argument.\n"));
+
+      parse_arg_max_memory(next_arg);
+      sit++;
     }
 
     // Options that apply to the next input file only.
@@ -30,7 +30,9 @@
 #include <windows.h>
 #endif
 
+#include <atomic>
 #include <iostream>
+#include <thread>
 #include <typeinfo>
 
 #include <ebml/EbmlHead.h>
@@ -64,6 +66,7 @@
 #include "common/ebml.h"
 #include "common/fs_sys_helpers.h"
 #include "common/hacks.h"
+#include "common/id3.h"
 #include "common/math.h"
 #include "common/mm_io_x.h"
 #include "common/mm_mpls_multi_file_io.h"
@@ -112,6 +115,7 @@
 #include "input/r_wavpack.h"
 #include "merge/cluster_helper.h"
 #include "merge/cues.h"
+#include "merge/memory_budget.h"
 #include "merge/output_control.h"
 #include "merge/webm.h"
 
@@ -195,6 +199,7 @@ append_mode_e g_append_mode                 = APPEND_MODE_FILE_BASED;
 bool s_appending_files                      = false;
 auto s_debug_appending                      = debugging_option_c{"append|appending"};
 auto s_debug_rerender_track_headers         = debugging_option_c{"rerender|rerender_track_headers"};
+auto s_debug_queued_bytes                   = debugging_option_c{"memory_budget|queued_bytes"};
 
 bool g_stereo_mode_used                     = false;
 
@@ -318,7 +323,9 @@ file_names_to_paths(const std::vector<std::string> &file_names) {
 static mm_io_cptr
 open_input_file(filelist_t &file) {
   try {
-    if (file.all_names.size() == 1)
+    // Playlist items are read via the multi file I/O class as well so
+    // that they profit from its prefetching.
+    if ((file.all_names.size() == 1) && !file.is_playlist)
       return mm_io_cptr(new mm_read_buffer_io_c(new mm_file_io_c(file.name), 1 << 17));
 
     else {
@@ -349,6 +356,43 @@ open_playlist_file(filelist_t &file,
   return true;
 }
 
+/** \brief Read the data the raw audio probes look at
+
+   The MP3, AC-3 and AAC probes are run several times with growing
+   probe sizes of up to 1 MB each. The AC-3 probe skips a leading
+   ID3v2 tag first. Reading that much data once and letting all
+   probes work on a copy in memory saves re-reading it from the
+   file for each of them.
+
+   Returns an empty pointer if the data cannot be read in full. The
+   caller will fall back to probing the file directly in that case.
+*/
+static memory_cptr
+read_raw_audio_probe_data(mm_io_c &io) {
+  static int64_t const s_max_probe_size = 1024 * 1024;
+  static int64_t const s_max_id3v2_size = 16 * 1024 * 1024;
+
+  try {
+    auto tag_size = std::max(skip_id3v2_tag(io), 0);
+    if (tag_size > s_max_id3v2_size)
+      return {};
+
+    auto to_read = std::min<int64_t>(io.get_size(), tag_size + s_max_probe_size);
+    if (0 >= to_read)
+      return {};
+
+    auto data = memory_c::alloc(to_read);
+    io.setFilePointer(0, seek_beginning);
+    auto num_read = io.read(data->get_buffer(), to_read);
+    io.setFilePointer(0, seek_beginning);
+
+    return static_cast<int64_t>(num_read) == to_read ? data : memory_cptr{};
+
+  } catch (...) {
+    return {};
+  }
+}
+
 /** \brief Probe the file type
 
    Opens the input file and calls the \c probe_file function for each known
@@ -366,6 +410,11 @@ get_file_type_internal(filelist_t &file) {
 
   file_type_e type = FILE_TYPE_IS_UNKNOWN;
 
+  // Data for the raw audio probes, read only once if they're reached.
+  auto raw_audio_data = memory_cptr{};
+  auto raw_audio_io   = mm_io_cptr{};
+  auto raw_io         = io;
+
   // All text file types (subtitles).
   auto text_io = mm_text_io_cptr{};
   try {
@@ -453,13 +502,19 @@ get_file_type_internal(filelist_t &file) {
     static const int s_probe_sizes[]                          = { 128 * 1024, 256 * 1024, 512 * 1024, 1024 * 1024, 0 };
     static const int s_probe_num_required_consecutive_packets = 64;
 
+    raw_audio_data = read_raw_audio_probe_data(*io);
+    if (raw_audio_data) {
+      raw_audio_io = std::make_shared<mm_mem_io_c>(*raw_audio_data);
+      raw_io       = raw_audio_io.get();
+    }
+
     int i;
     for (i = 0; (0 != s_probe_sizes[i]) && (FILE_TYPE_IS_UNKNOWN == type); ++i)
-      if (mp3_reader_c::probe_file(io, size, s_probe_sizes[i], s_probe_num_required_consecutive_packets))
+      if (mp3_reader_c::probe_file(raw_io, size, s_probe_sizes[i], s_probe_num_required_consecutive_packets))
         type = FILE_TYPE_MP3;
-      else if (ac3_reader_c::probe_file(io, size, s_probe_sizes[i], s_probe_num_required_consecutive_packets))
+      else if (ac3_reader_c::probe_file(raw_io, size, s_probe_sizes[i], s_probe_num_required_consecutive_packets))
         type = FILE_TYPE_AC3;
-      else if (aac_reader_c::probe_file(io, size, s_probe_sizes[i], s_probe_num_required_consecutive_packets))
+      else if (aac_reader_c::probe_file(raw_io, size, s_probe_sizes[i], s_probe_num_required_consecutive_packets))
         type = FILE_TYPE_AAC;
   }
   // More file types with detection issues.
@@ -475,11 +530,11 @@ get_file_type_internal(filelist_t &file) {
   // Try some more of the raw audio formats before trying h.264 (which
   // often enough simply works). However, require that the first frame
   // starts at the beginning of the file.
-  else if (mp3_reader_c::probe_file(io, size, 32 * 1024, 1, true))
+  else if (mp3_reader_c::probe_file(raw_io, size, 32 * 1024, 1, true))
     type = FILE_TYPE_MP3;
-  else if (ac3_reader_c::probe_file(io, size, 32 * 1024, 1, true))
+  else if (ac3_reader_c::probe_file(raw_io, size, 32 * 1024, 1, true))
     type = FILE_TYPE_AC3;
-  else if (aac_reader_c::probe_file(io, size, 32 * 1024, 1, true))
+  else if (aac_reader_c::probe_file(raw_io, size, 32 * 1024, 1, true))
     type = FILE_TYPE_AAC;
 
   else if (avc_es_reader_c::probe_file(io, size))
@@ -494,11 +549,11 @@ get_file_type_internal(filelist_t &file) {
 
     int i;
     for (i = 0; (0 != s_probe_sizes[i]) && (FILE_TYPE_IS_UNKNOWN == type); ++i)
-      if (mp3_reader_c::probe_file(io, size, s_probe_sizes[i], s_probe_num_required_consecutive_packets))
+      if (mp3_reader_c::probe_file(raw_io, size, s_probe_sizes[i], s_probe_num_required_consecutive_packets))
         type = FILE_TYPE_MP3;
-      else if (ac3_reader_c::probe_file(io, size, s_probe_sizes[i], s_probe_num_required_consecutive_packets))
+      else if (ac3_reader_c::probe_file(raw_io, size, s_probe_sizes[i], s_probe_num_required_consecutive_packets))
         type = FILE_TYPE_AC3;
-      else if (aac_reader_c::probe_file(io, size, s_probe_sizes[i], s_probe_num_required_consecutive_packets))
+      else if (aac_reader_c::probe_file(raw_io, size, s_probe_sizes[i], s_probe_num_required_consecutive_packets))
         type = FILE_TYPE_AAC;
   }
 
@@ -1882,6 +1937,102 @@ finish_file(bool last_file,
 
 static void establish_deferred_connections(filelist_t &file);
 
+/** \brief Read the beginning of files that will be appended
+
+   For each file that will be appended to a file that is currently
+   being read a thread is started. It reads up to 32 MB from the
+   position the appended file's reader is currently at with its own
+   file handle. The data is discarded; the point is to have the
+   operating system cache it by the time the reader is switched
+   to. Readers and packetizers are not touched as the timecode
+   offsets for the appended tracks are only known once the previous
+   file has finished.
+*/
+class append_prefetcher_c {
+private:
+  std::vector<std::thread> m_threads;
+  std::vector<bool> m_started;
+  std::atomic<bool> m_stop;
+
+public:
+  append_prefetcher_c()
+    : m_stop{false}
+  {
+  }
+
+  ~append_prefetcher_c() {
+    stop();
+  }
+
+  void prefetch_files_appended_to(filelist_t const &file);
+  void stop();
+
+protected:
+  void prefetch(std::string const &file_name, int64_t start);
+};
+
+void
+append_prefetcher_c::prefetch_files_appended_to(filelist_t const &file) {
+  if (!s_appending_files || m_stop || hack_engaged(ENGAGE_NO_PREFETCHING))
+    return;
+
+  m_started.resize(g_files.size(), false);
+
+  for (auto &amap : g_append_mapping) {
+    if ((amap.dst_file_id != file.id) || m_started[amap.src_file_id])
+      continue;
+
+    m_started[amap.src_file_id] = true;
+
+    auto &src_file = g_files[amap.src_file_id];
+    if ((src_file.all_names.size() != 1) || src_file.is_playlist || !src_file.reader || !src_file.reader->m_in)
+      continue;
+
+    auto file_name = src_file.name;
+    auto start     = static_cast<int64_t>(src_file.reader->m_in->getFilePointer());
+
+    mxdebug_if(s_debug_appending, boost::format("appending: prefetching '%1%' from %2%\n") % file_name % start);
+
+    m_threads.emplace_back([this, file_name, start]() { prefetch(file_name, start); });
+  }
+}
+
+void
+append_prefetcher_c::prefetch(std::string const &file_name,
+                              int64_t start) {
+  static int64_t const s_prefetch_size = 32 * 1024 * 1024;
+  static int64_t const s_chunk_size    = 1024 * 1024;
+
+  try {
+    auto in     = mm_file_io_c::open(file_name);
+    auto buffer = memory_c::alloc(s_chunk_size);
+    auto left   = s_prefetch_size;
+
+    in->setFilePointer(start, seek_beginning);
+
+    while (!m_stop && (0 < left)) {
+      auto num_read = in->read(buffer->get_buffer(), std::min(left, s_chunk_size));
+      if (!num_read)
+        break;
+      left -= num_read;
+    }
+
+  } catch (...) {
+  }
+}
+
+void
+append_prefetcher_c::stop() {
+  m_stop = true;
+
+  for (auto &thread : m_threads)
+    thread.join();
+
+  m_threads.clear();
+}
+
+static append_prefetcher_c s_append_prefetcher;
+
 /** \brief Append a packetizer to another one
 
    Appends a packetizer to another one. Finds the packetizer that is
@@ -2080,6 +2231,9 @@ append_track(packetizer_t &ptzr,
   }
 
   ptzr.deferred = false;
+
+  // Now that this file is being read warm up the one following it.
+  s_append_prefetcher.prefetch_files_appended_to(src_file);
 }
 
 /** \brief Decide if packetizers have to be appended
@@ -2188,6 +2342,28 @@ pull_packetizers_for_packets() {
   }
 }
 
+static void
+spill_queued_packets() {
+  if (!memory_budget_c::is_exceeded())
+    return;
+
+  for (auto &ptzr : g_packetizers)
+    ptzr.packetizer->spill_queued_packets();
+}
+
+static void
+display_peak_queued_bytes() {
+  for (auto &ptzr : g_packetizers)
+    mxdebug(boost::format("Peak queued bytes for '%1%' track %2%: %3%\n") % ptzr.packetizer->m_ti.m_fname % ptzr.packetizer->m_ti.m_id % format_file_size(ptzr.packetizer->get_peak_queued_bytes()));
+
+  mxdebug(boost::format("Peak queued bytes for all tracks: %1% (limit: %2%)\n")
+          % format_file_size(memory_budget_c::get_peak_queued_bytes())
+          % (memory_budget_c::is_limited() ? format_file_size(memory_budget_c::get_max_bytes()) : std::string{"none"}));
+
+  if (memory_budget_c::is_limited())
+    mxdebug(boost::format("Peak bytes moved to the temporary file: %1%\n") % format_file_size(memory_budget_c::get_peak_spilled_bytes()));
+}
+
 static packetizer_t *
 select_winning_packetizer() {
   packetizer_t *winner = nullptr;
@@ -2214,6 +2390,23 @@ discard_queued_packets() {
   g_cluster_helper->discard_queued_packets();
 }
 
+/** \brief Let readers jump over data that would be discarded anyway
+
+   Used by the cluster helper when splitting by parts: readers that
+   can locate key frames via an index skip ahead to the last key frame
+   at or before \c timecode instead of having all the data in between
+   read, processed and thrown away.
+*/
+void
+skip_readers_to_timecode(timecode_c const &timecode) {
+  if (s_appending_files)
+    return;
+
+  for (auto &file : g_files)
+    if (!file.done && !file.is_playlist && file.reader->can_skip_to_timecode())
+      file.reader->skip_to_timecode(timecode);
+}
+
 /** \brief Request packets and handle the next one
 
    Requests packets from each packetizer, selects the packet with the
@@ -2222,12 +2415,23 @@ discard_queued_packets() {
 */
 void
 main_loop() {
+  if (g_cluster_helper)
+    g_cluster_helper->skip_discarded_range();
+
+  for (auto &file : g_files)
+    if (!file.appending)
+      s_append_prefetcher.prefetch_files_appended_to(file);
+
   // Let's go!
   while (1) {
     // Step 1: Make sure a packet is available for each output
     // as long we haven't already processed the last one.
     pull_packetizers_for_packets();
 
+    // Move queued data out of memory if the global budget is
+    // exceeded. This must not influence which packet is chosen next.
+    spill_queued_packets();
+
     // Step 2: Pick the packet with the lowest timecode and
     // stuff it into the Matroska file.
     auto winner = select_winning_packetizer();
@@ -2259,12 +2463,17 @@ main_loop() {
       break;
   }
 
+  s_append_prefetcher.stop();
+
   // Render all remaining packets (if there are any).
   if (g_cluster_helper && (0 < g_cluster_helper->get_packet_count()))
     g_cluster_helper->render();
 
   if (1 <= verbose)
     display_progress(true);
+
+  if (s_debug_queued_bytes)
+    display_peak_queued_bytes();
 }
 
 /** \brief Deletes the file readers and other associated objects
@@ -257,6 +257,7 @@ void check_append_mapping();
 
 void cleanup();
 void main_loop();
+void skip_readers_to_timecode(timecode_c const &timecode);
 
 void add_packetizer_globally(generic_packetizer_c *packetizer);
 void add_tags(KaxTag *tags);
@@ -61,6 +61,7 @@ struct packet_t {
   timecode_c discard_padding, output_order_timecode;
   bool duration_mandatory, superseeded, gap_following, factory_applied;
   generic_packetizer_c *source;
+  int64_t spilled_position, spilled_size;
 
   std::vector<packet_extension_cptr> extensions;
 
@@ -84,6 +85,8 @@ struct packet_t {
     , gap_following{}
     , factory_applied{}
     , source{}
+    , spilled_position(-1)
+    , spilled_size{}
   {
   }
 
@@ -112,6 +115,8 @@ struct packet_t {
     , gap_following{}
     , factory_applied{}
     , source{}
+    , spilled_position(-1)
+    , spilled_size{}
   {
   }
 
@@ -140,6 +145,8 @@ struct packet_t {
     , gap_following{}
     , factory_applied{}
     , source{}
+    , spilled_position(-1)
+    , spilled_size{}
   {
   }
 
@@ -170,6 +177,18 @@ struct packet_t {
     return 0 <= duration;
   }
 
+  bool
+  is_spilled()
+    const {
+    return 0 <= spilled_position;
+  }
+
+  int64_t
+  get_data_size()
+    const {
+    return is_spilled() ? spilled_size : data->get_size();
+  }
+
   bool
   has_discard_padding()
     const {
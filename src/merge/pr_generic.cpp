@@ -33,6 +33,7 @@
 #include "common/strings/formatting.h"
 #include "common/unique_numbers.h"
 #include "common/xml/ebml_tags_converter.h"
+#include "merge/memory_budget.h"
 #include "merge/output_control.h"
 #include "merge/pr_generic.h"
 #include "merge/webm.h"
@@ -62,6 +63,7 @@ generic_packetizer_c::generic_packetizer_c(generic_reader_c *reader,
   , m_free_refs(-1)
   , m_next_free_refs(-1)
   , m_enqueued_bytes(0)
+  , m_peak_enqueued_bytes(0)
   , m_safety_last_timecode(0)
   , m_safety_last_duration(0)
   , m_track_entry(nullptr)
@@ -815,7 +817,7 @@ generic_packetizer_c::add_packet(packet_cptr pack) {
 
   pack->source = this;
 
-  m_enqueued_bytes += pack->data->get_size();
+  account_queued_bytes(pack->data->get_size());
 
   if ((0 > pack->bref) && (0 <= pack->fref))
     std::swap(pack->bref, pack->fref);
@@ -909,9 +911,12 @@ generic_packetizer_c::get_packet() {
   packet_cptr pack = m_packet_queue.front();
   m_packet_queue.pop_front();
 
+  if (pack->is_spilled())
+    memory_budget_c::restore(*pack);
+
   pack->output_order_timecode = timecode_c::ns(pack->assigned_timecode - std::max(m_codec_delay.to_ns(0), m_seek_pre_roll.to_ns(0)));
 
-  m_enqueued_bytes -= pack->data->get_size();
+  account_queued_bytes(-static_cast<int64_t>(pack->data->get_size()));
 
   --m_next_packet_wo_assigned_timecode;
   if (0 > m_next_packet_wo_assigned_timecode)
@@ -1122,6 +1127,17 @@ generic_packetizer_c::contains_gap() {
   return m_timecode_factory ? m_timecode_factory->contains_gap() : false;
 }
 
+bool
+generic_packetizer_c::has_unmodified_timecodes()
+  const {
+  return !m_timecode_factory
+      && !m_ti.m_reset_timecodes
+      && (0 == m_ti.m_tcsync.displacement)
+      && (m_ti.m_tcsync.numerator == m_ti.m_tcsync.denominator)
+      && (0 == m_correction_timecode_offset)
+      && (0 == m_append_timecode_offset);
+}
+
 void
 generic_packetizer_c::flush() {
   flush_impl();
@@ -1142,9 +1158,45 @@ generic_packetizer_c::is_compatible_with(output_compatibility_e compatibility) {
 
 void
 generic_packetizer_c::discard_queued_packets() {
+  for (auto &packet : m_packet_queue) {
+    auto size = packet->get_data_size();
+    if (packet->is_spilled())
+      memory_budget_c::forget(*packet);
+
+    account_queued_bytes(-size);
+  }
+
   m_packet_queue.clear();
 }
 
+/** \brief Move the payload of queued packets to the spill file
+
+   Called by the main loop while the global memory budget is
+   exceeded. The most recently queued packets are spilled first as
+   they will be needed last. The packet at the front of the queue is
+   always kept in memory. Only the payload is moved; timecodes and
+   everything else the packetizer and the timecode factory work with
+   stay where they are.
+*/
+void
+generic_packetizer_c::spill_queued_packets() {
+  for (auto idx = m_packet_queue.size(); (1 < idx) && memory_budget_c::is_exceeded(); --idx) {
+    auto &packet = *m_packet_queue[idx - 1];
+    if (packet.is_spilled())
+      break;
+
+    memory_budget_c::spill(packet);
+  }
+}
+
+void
+generic_packetizer_c::account_queued_bytes(int64_t num_bytes) {
+  m_enqueued_bytes      += num_bytes;
+  m_peak_enqueued_bytes  = std::max(m_peak_enqueued_bytes, m_enqueued_bytes);
+
+  memory_budget_c::account(num_bytes);
+}
+
 bool
 generic_packetizer_c::wants_cue_duration()
   const {
@@ -1274,6 +1326,19 @@ generic_reader_c::get_timecode_restriction_max()
   return m_restricted_timecodes_max;
 }
 
+bool
+generic_reader_c::can_skip_to_timecode()
+  const {
+  if (m_appending || m_restricted_timecodes_min.valid() || m_restricted_timecodes_max.valid())
+    return false;
+
+  for (auto ptzr : m_reader_packetizers)
+    if (!ptzr->has_unmodified_timecodes())
+      return false;
+
+  return true;
+}
+
 void
 generic_reader_c::read_all() {
   for (auto &packetizer : m_reader_packetizers)
@@ -1406,6 +1471,18 @@ generic_reader_c::get_queued_bytes()
   return bytes;
 }
 
+/** \brief Reader specific limit for the number of queued bytes
+
+   Readers use this for their own holding thresholds. Those do not
+   depend on the global memory budget as holding changes the order in
+   which packets are written.
+*/
+bool
+generic_reader_c::queued_bytes_exceed(int64_t limit)
+  const {
+  return limit < get_queued_bytes();
+}
+
 file_status_e
 generic_reader_c::flush_packetizer(int num) {
   return flush_packetizer(PTZR(num));
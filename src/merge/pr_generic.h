@@ -376,6 +376,14 @@ public:
   virtual void read_headers() = 0;
   virtual file_status_e read(generic_packetizer_c *ptzr, bool force = false) = 0;
   virtual void read_all();
+
+  // Readers with an index may reposition themselves on the last key
+  // frame at or before the given timecode if that lies ahead of their
+  // current position. Returns true if such a skip was performed.
+  virtual bool skip_to_timecode(timecode_c const &) {
+    return false;
+  }
+  virtual bool can_skip_to_timecode() const;
   virtual int get_progress();
   virtual void set_headers();
   virtual void set_headers_for_track(int64_t tid);
@@ -402,6 +410,7 @@ public:
     return m_in->get_size();
   }
   virtual int64_t get_queued_bytes() const;
+  virtual bool queued_bytes_exceed(int64_t limit) const;
   virtual bool is_simple_subtitle_container() {
     return false;
   }
@@ -448,7 +457,7 @@ protected:
   std::deque<packet_cptr> m_packet_queue, m_deferred_packets;
   int m_next_packet_wo_assigned_timecode;
 
-  int64_t m_free_refs, m_next_free_refs, m_enqueued_bytes;
+  int64_t m_free_refs, m_next_free_refs, m_enqueued_bytes, m_peak_enqueued_bytes;
   int64_t m_safety_last_timecode, m_safety_last_duration;
 
   KaxTrackEntry *m_track_entry;
@@ -497,6 +506,7 @@ public:
   virtual ~generic_packetizer_c();
 
   virtual bool contains_gap();
+  virtual bool has_unmodified_timecodes() const;
 
   virtual file_status_e read() {
     return m_reader->read(this);
@@ -514,6 +524,7 @@ public:
     return !m_packet_queue.empty() && m_packet_queue.front()->factory_applied;
   }
   void discard_queued_packets();
+  void spill_queued_packets();
   void flush();
   virtual int64_t get_smallest_timecode() const {
     return m_packet_queue.empty() ? 0x0FFFFFFF : m_packet_queue.front()->timecode;
@@ -521,6 +532,9 @@ public:
   inline int64_t get_queued_bytes() const {
     return m_enqueued_bytes;
   }
+  inline int64_t get_peak_queued_bytes() const {
+    return m_peak_enqueued_bytes;
+  }
 
   inline void set_free_refs(int64_t free_refs) {
     m_free_refs      = m_next_free_refs;
@@ -657,6 +671,8 @@ protected:
   };
 
   virtual void show_experimental_status_version(std::string const &codec_id);
+
+  void account_queued_bytes(int64_t num_bytes);
 };
 
 extern std::vector<generic_packetizer_c *> ptzrs_in_header_order;
@@ -130,29 +130,25 @@ timecode_factory_v1_c::parse(mm_io_c &in) {
     t.start_frame = 0;
   else {
     std::sort(m_ranges.begin(), m_ranges.end());
-    bool done;
-    do {
-      done = true;
-      iit  = m_ranges.begin();
-      size_t i;
-      for (i = 0; i < (m_ranges.size() - 1); i++) {
-        iit++;
-        if (m_ranges[i].end_frame < (m_ranges[i + 1].start_frame - 1)) {
-          t.start_frame = m_ranges[i].end_frame + 1;
-          t.end_frame = m_ranges[i + 1].start_frame - 1;
-          t.fps = m_default_fps;
-          m_ranges.insert(iit, t);
-          done = false;
-          break;
-        }
+
+    // Fill the holes between the ranges (and before the first one)
+    // with the default FPS in a single pass.
+    std::vector<timecode_range_c> ranges;
+    ranges.reserve(m_ranges.size() * 2 + 2);
+
+    for (auto const &range : m_ranges) {
+      if (ranges.empty() ? (0 != range.start_frame) : (ranges.back().end_frame < (range.start_frame - 1))) {
+        t.start_frame = ranges.empty() ? 0 : ranges.back().end_frame + 1;
+        t.end_frame   = range.start_frame - 1;
+        t.fps         = m_default_fps;
+        ranges.push_back(t);
       }
-    } while (!done);
-    if (m_ranges[0].start_frame != 0) {
-      t.start_frame = 0;
-      t.end_frame = m_ranges[0].start_frame - 1;
-      t.fps = m_default_fps;
-      m_ranges.insert(m_ranges.begin(), t);
+
+      ranges.push_back(range);
     }
+
+    m_ranges.swap(ranges);
+
     t.start_frame = m_ranges[m_ranges.size() - 1].end_frame + 1;
   }
 
@@ -190,26 +186,40 @@ timecode_factory_v1_c::get_at(uint64_t frame) {
   if ((frame > t->end_frame) && (m_current_range < (m_ranges.size() - 1)))
     t = &m_ranges[m_current_range + 1];
 
+  // Frames outside the current and the following range: find the last
+  // range starting at or before the frame. The first range always
+  // starts at frame 0.
+  if ((frame < t->start_frame) || (frame > t->end_frame)) {
+    auto itr = std::upper_bound(m_ranges.begin(), m_ranges.end(), frame, [](uint64_t wanted_frame, timecode_range_c const &range) {
+      return wanted_frame < range.start_frame;
+    });
+    t = &*(itr - 1);
+  }
+
   return (int64_t)(t->base_timecode + 1000000000.0 * (frame - t->start_frame) / t->fps);
 }
 
 void
 timecode_factory_v2_c::parse(mm_io_c &in) {
-  std::string line;
   std::map<int64_t, int64_t> dur_map;
 
   int64_t dur_sum          = 0;
   int line_no              = 0;
   double previous_timecode = 0;
 
-  while (in.getline2(line)) {
+  auto parse_line = [&](char const *begin, char const *end) {
     line_no++;
-    strip(line);
-    if ((line.length() == 0) || (line[0] == '#'))
-      continue;
+
+    while ((begin < end) && isblanktab(*begin))
+      ++begin;
+    while ((begin < end) && isblanktab(*(end - 1)))
+      --end;
+
+    if ((begin == end) || (*begin == '#'))
+      return;
 
     double timecode;
-    if (!parse_number(line.c_str(), timecode))
+    if (!parse_number(begin, end, timecode))
       mxerror(boost::format(Y("The line %1% of the timecode file '%2%' does not contain a valid floating point number.\n")) % line_no % m_file_name);
 
     if ((2 == m_version) && (timecode < previous_timecode))
@@ -227,13 +237,28 @@ timecode_factory_v2_c::parse(mm_io_c &in) {
     m_timecodes.push_back((int64_t)(timecode * 1000000));
     if (m_timecodes.size() > 1) {
       int64_t duration = m_timecodes[m_timecodes.size() - 1] - m_timecodes[m_timecodes.size() - 2];
-      if (dur_map.find(duration) == dur_map.end())
-        dur_map[duration] = 1;
-      else
-        dur_map[duration] = dur_map[duration] + 1;
+      ++dur_map[duration];
       dur_sum += duration;
       m_durations.push_back(duration);
     }
+  };
+
+  // Text files are read in one go by getlines() instead of byte by
+  // byte; this also allows reserving space for all entries.
+  auto text_in = dynamic_cast<mm_text_io_c *>(&in);
+  if (text_in) {
+    auto lines = text_in->getlines();
+
+    m_timecodes.reserve(lines.size());
+    m_durations.reserve(lines.size());
+
+    for (auto const &line : lines)
+      parse_line(line.c_str(), line.c_str() + line.length());
+
+  } else {
+    std::string line;
+    while (in.getline2(line))
+      parse_line(line.c_str(), line.c_str() + line.length());
   }
 
   if (m_timecodes.empty())
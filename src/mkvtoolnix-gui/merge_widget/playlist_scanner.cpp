@@ -10,7 +10,9 @@
 #include <QApplication>
 #include <QDir>
 #include <QFileInfo>
+#include <QProcess>
 #include <QProgressDialog>
+#include <QRegExp>
 #include <QString>
 
 PlaylistScanner::PlaylistScanner(QWidget *parent)
@@ -68,28 +70,122 @@ PlaylistScanner::scanForPlaylists(QFileInfoList const &otherFiles) {
   progress.setWindowModality(Qt::ApplicationModal);
 
   auto identifiedFiles = QList<SourceFilePtr>{};
-  auto numScanned      = 0u;
+
+  if (!identifyWithServer(otherFiles, progress, identifiedFiles))
+    identifyOneByOne(otherFiles, progress, identifiedFiles);
+
+  if (progress.wasCanceled())
+    return QList<SourceFilePtr>{};
+
+  progress.setValue(otherFiles.size());
+
+  std::sort(identifiedFiles.begin(), identifiedFiles.end(), [](SourceFilePtr const &a, SourceFilePtr const &b) { return a->m_fileName < b->m_fileName; });
+
+  return identifiedFiles;
+}
+
+// Identifies all files with a single 'mkvmerge --identify-server'
+// process instead of starting one process per file. Returns false if
+// the server cannot be used; the caller falls back to identifying the
+// files one by one then.
+bool
+PlaylistScanner::identifyWithServer(QFileInfoList const &otherFiles,
+                                    QProgressDialog &progress,
+                                    QList<SourceFilePtr> &identifiedFiles) {
+#if defined(SYS_WINDOWS)
+  Q_UNUSED(otherFiles);
+  Q_UNUSED(progress);
+  Q_UNUSED(identifiedFiles);
+
+  return false;
+
+#else  // defined(SYS_WINDOWS)
+  QProcess server;
+  server.start(Settings::get().m_mkvmergeExe, QStringList{} << "--output-charset" << "utf-8" << "--identify-server" << "--identify-for-mmg");
+  if (!server.waitForStarted(-1))
+    return false;
+
+  for (auto const &otherFile : otherFiles)
+    server.write(QString{"%1\n"}.arg(otherFile.filePath()).toUtf8());
+  server.closeWriteChannel();
+
+  QRegExp doneRe{"^--- identify-server done: (\\d+) ---$"};
+  auto output     = QStringList{};
+  auto numScanned = 0;
+
+  updateProgress(progress, 0, otherFiles.size());
+
+  while (numScanned < otherFiles.size()) {
+    if (!server.canReadLine() && !server.waitForReadyRead(100) && (QProcess::NotRunning == server.state()) && !server.canReadLine())
+      break;
+
+    qApp->processEvents();
+    if (progress.wasCanceled()) {
+      server.kill();
+      server.waitForFinished(-1);
+      return true;
+    }
+
+    while ((numScanned < otherFiles.size()) && server.canReadLine()) {
+      auto line = QString::fromUtf8(server.readLine()).remove(QRegExp{"[\r\n]+$"});
+      if (-1 == doneRe.indexIn(line)) {
+        output << line;
+        continue;
+      }
+
+      FileIdentifier identifier{m_parent, otherFiles[numScanned].filePath()};
+      if (identifier.handleOutput(doneRe.cap(1).toInt(), output))
+        addIfPlaylist(identifier, identifiedFiles);
+
+      output.clear();
+      updateProgress(progress, ++numScanned, otherFiles.size());
+    }
+  }
+
+  server.waitForFinished(-1);
+
+  // The server did not deliver results for all files, e.g. because
+  // the mkvmerge executable is too old to know '--identify-server'.
+  if (numScanned < otherFiles.size()) {
+    identifiedFiles.clear();
+    return false;
+  }
+
+  return true;
+#endif  // defined(SYS_WINDOWS)
+}
+
+void
+PlaylistScanner::identifyOneByOne(QFileInfoList const &otherFiles,
+                                  QProgressDialog &progress,
+                                  QList<SourceFilePtr> &identifiedFiles) {
+  auto numScanned = 0u;
 
   for (auto const &otherFile : otherFiles) {
-    progress.setLabelText(QNY("%1 of %2 file processed", "%1 of %2 files processed", otherFiles.size()).arg(numScanned).arg(otherFiles.size()));
-    progress.setValue(numScanned++);
+    updateProgress(progress, numScanned++, otherFiles.size());
 
     qApp->processEvents();
     if (progress.wasCanceled())
-      return QList<SourceFilePtr>{};
+      return;
 
     FileIdentifier identifier{m_parent, otherFile.filePath()};
-    if (!identifier.identify())
-      continue;
-
-    auto file = identifier.file();
-    if (file->isPlaylist() && (file->m_playlistDuration >= (Settings::get().m_minimumPlaylistDuration * 1000000000ull)))
-      identifiedFiles << file;
+    if (identifier.identify())
+      addIfPlaylist(identifier, identifiedFiles);
   }
+}
 
-  progress.setValue(otherFiles.size());
-
-  std::sort(identifiedFiles.begin(), identifiedFiles.end(), [](SourceFilePtr const &a, SourceFilePtr const &b) { return a->m_fileName < b->m_fileName; });
+void
+PlaylistScanner::addIfPlaylist(FileIdentifier const &identifier,
+                               QList<SourceFilePtr> &identifiedFiles) {
+  auto file = identifier.file();
+  if (file->isPlaylist() && (file->m_playlistDuration >= (Settings::get().m_minimumPlaylistDuration * 1000000000ull)))
+    identifiedFiles << file;
+}
 
-  return identifiedFiles;
+void
+PlaylistScanner::updateProgress(QProgressDialog &progress,
+                                unsigned int numScanned,
+                                unsigned int numFiles) {
+  progress.setLabelText(QNY("%1 of %2 file processed", "%1 of %2 files processed", numFiles).arg(numScanned).arg(numFiles));
+  progress.setValue(numScanned);
 }
@@ -7,6 +7,8 @@
 
 #include <QList>
 
+class FileIdentifier;
+class QProgressDialog;
 class QWidget;
 
 class PlaylistScanner {
@@ -21,6 +23,10 @@ public:
 protected:
   bool askScanForPlaylists(SourceFile const &file, unsigned int numOtherFiles);
   QList<SourceFilePtr> scanForPlaylists(QFileInfoList const &otherFiles);
+  bool identifyWithServer(QFileInfoList const &otherFiles, QProgressDialog &progress, QList<SourceFilePtr> &identifiedFiles);
+  void identifyOneByOne(QFileInfoList const &otherFiles, QProgressDialog &progress, QList<SourceFilePtr> &identifiedFiles);
+  void addIfPlaylist(FileIdentifier const &identifier, QList<SourceFilePtr> &identifiedFiles);
+  void updateProgress(QProgressDialog &progress, unsigned int numScanned, unsigned int numFiles);
 };
 
 #endif // MTX_MKVTOOLNIX_GUI_MERGE_WIDGET_PLAYLIST_SCANNER_H
@@ -28,9 +28,16 @@ FileIdentifier::identify() {
   QStringList args;
   args << "--output-charset" << "utf-8" << "--identify-for-mmg" << m_fileName;
 
-  auto process  = Process::execute(Settings::get().m_mkvmergeExe, args);
-  auto exitCode = process->process().exitCode();
-  m_output      = process->output();
+  auto process = Process::execute(Settings::get().m_mkvmergeExe, args);
+
+  return handleOutput(process->process().exitCode(), process->output());
+}
+
+bool
+FileIdentifier::handleOutput(int exitCode,
+                             QStringList const &output) {
+  m_exitCode = exitCode;
+  m_output   = output;
 
   if (0 == exitCode)
     return parseOutput();
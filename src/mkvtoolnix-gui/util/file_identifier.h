@@ -23,6 +23,7 @@ public:
   virtual ~FileIdentifier();
 
   virtual bool identify();
+  virtual bool handleOutput(int exitCode, QStringList const &output);
   virtual bool parseOutput();
   virtual QHash<QString, QString> parseProperties(QString const &line) const;
   virtual void parseAttachmentLine(QString const &line);
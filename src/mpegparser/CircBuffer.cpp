@@ -61,6 +61,32 @@ int32_t CircBuffer::Skip(uint32_t numBytes){
   }
 }
 
+int32_t CircBuffer::Find(binary value, uint32_t startPos, uint32_t endPos){
+  if(endPos > bytes_in_buf)
+    endPos = bytes_in_buf;
+
+  //The data consists of at most two contiguous parts: up to the end of
+  //the buffer and from its start.
+  uint32_t bbw = bytes_before_wrap_read();
+  if(startPos < bbw){
+    uint32_t firstEnd = std::min(endPos, bbw);
+    if(startPos < firstEnd){
+      binary* hit = (binary*)memchr(read_ptr + startPos, value, firstEnd - startPos);
+      if(hit)
+        return hit - read_ptr;
+    }
+    startPos = bbw;
+  }
+
+  if(startPos < endPos){
+    binary* hit = (binary*)memchr(m_buf + (startPos - bbw), value, endPos - startPos);
+    if(hit)
+      return (hit - m_buf) + bbw;
+  }
+
+  return -1;
+}
+
 int32_t CircBuffer::Read(binary* dest, uint32_t numBytes){
   if(can_read(numBytes)){
     unsigned int bbw = bytes_before_wrap_read(); //how many bytes we have before the buffer must be wrapped
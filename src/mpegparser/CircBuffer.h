@@ -104,6 +104,8 @@ public:
   int32_t Read(binary* dest, uint32_t numBytes);
   int32_t Skip(uint32_t numBytes);
   int32_t Write(binary* data, uint32_t numBytes);
+  //Returns the position of the first byte equal to value in [startPos, endPos) or -1.
+  int32_t Find(binary value, uint32_t startPos, uint32_t endPos);
 
   uint32_t GetLength(){
     return bytes_in_buf;
@@ -137,8 +137,7 @@ int32_t M2VParser::InitParser(){
     chunk = chunks[i];
     if(chunk->GetType() == MPEG_VIDEO_SEQUENCE_START_CODE){
       //Copy the header for later, we must copy because the actual chunk will be deleted in a bit
-      binary * hdrData = new binary[chunk->GetSize()];
-      memcpy(hdrData, chunk->GetPointer(), chunk->GetSize());
+      binary * hdrData = (binary *)safememdup(chunk->GetPointer(), chunk->GetSize());
       seqHdrChunk = new MPEGChunk(hdrData, chunk->GetSize()); //Save this for adding as private data...
       ParseSequenceHeader(chunk, m_seqHdr);
 
@@ -290,14 +289,12 @@ int32_t M2VParser::OrderFrame(MPEGFrame* frame){
 
 int32_t M2VParser::PrepareFrame(MPEGChunk* chunk, MediaTime timecode, MPEG2PictureHeader picHdr){
   MPEGFrame* outBuf;
-  bool bCopy = true;
-  binary* pData = chunk->GetPointer();
+  binary* pData;
   uint32_t dataLen = chunk->GetSize();
 
   if ((seqHdrChunk && keepSeqHdrsInBitstream &&
        (MPEG2_I_FRAME == picHdr.frameType)) || gopChunk) {
     uint32_t pos = 0;
-    bCopy = false;
     dataLen +=
       (seqHdrChunk && keepSeqHdrsInBitstream ? seqHdrChunk->GetSize() : 0) +
       (gopChunk ? gopChunk->GetSize() : 0);
@@ -316,9 +313,12 @@ int32_t M2VParser::PrepareFrame(MPEGChunk* chunk, MediaTime timecode, MPEG2Pictu
       gopChunk = nullptr;
     }
     memcpy(pData + pos, chunk->GetPointer(), chunk->GetSize());
+  } else {
+    //Nothing to prepend: the frame takes over the chunk's data.
+    pData = chunk->ReleaseData();
   }
 
-  outBuf = new MPEGFrame(pData, dataLen, bCopy);
+  outBuf = new MPEGFrame(pData, dataLen, false);
 
   if (seqHdrChunk && !keepSeqHdrsInBitstream &&
       (MPEG2_I_FRAME == picHdr.frameType)) {
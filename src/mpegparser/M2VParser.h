@@ -61,7 +61,7 @@ public:
 
 class M2VParser {
 private:
-  std::vector<MPEGChunk*> chunks; //Hold the chunks until we can order them
+  std::deque<MPEGChunk*> chunks; //Hold the chunks until we can order them
   std::queue<MPEGFrame*> waitQueue; //Holds unstamped buffers until we can stamp them.
   std::queue<MPEGFrame*> buffers; //Holds stamped buffers until they are requested.
   MediaTime previousTimecode;
@@ -39,29 +39,30 @@ MPEG2PictureHeader::MPEG2PictureHeader() {
 }
 
 int32_t MPEGVideoBuffer::FindStartCode(uint32_t startPos){
-  //How many bytes can we look through?
-  uint32_t window = myBuffer->GetLength() - startPos;
+  CircBuffer& buf = *myBuffer;
+  uint32_t length = buf.GetLength();
 
-  if(window < 4) //Make sure we have enough bytes to search.
+  if(length < (startPos + 4)) //Make sure we have enough bytes to search.
     return -1;
 
-  for(unsigned int i = startPos; i < (window - 3); i++){
-    CircBuffer& buf = *myBuffer;
-    binary a,b,c,d;
-    a = buf[i];
-    b = buf[i+1];
-    c = buf[i+2];
-    d = buf[i+3];
-    if((a == 0x00) && (b == 0x00) && (c == 0x01)){
-      switch(d){
+  //Look for the 0x01 of 0x00 0x00 0x01 xx; xx must be available, too.
+  uint32_t pos = startPos + 2;
+  while(true){
+    int32_t found = buf.Find(0x01, pos, length - 1);
+    if(found == -1)
+      break;
+
+    if((buf[found - 2] == 0x00) && (buf[found - 1] == 0x00)){
+      switch(buf[found + 1]){
         case MPEG_VIDEO_SEQUENCE_START_CODE:
         case MPEG_VIDEO_GOP_START_CODE:
         case MPEG_VIDEO_PICTURE_START_CODE:
-          return i;  //Return our position if we found
+          return found - 2;  //Return our position if we found
           //one of the codes we want
 
       }
     }
+    pos = found + 1;
   }
 
   //If we get here we have no _wanted_ start code found.
@@ -75,15 +76,23 @@ void MPEGVideoBuffer::UpdateState(){
     state = MPEG2_BUFFER_STATE_EMPTY;
     return;
   }
+  //Everything before scanPos has already been searched without success.
+  uint32_t length = myBuffer->GetLength();
+  uint32_t nextScanPos = length > 3 ? length - 3 : 0;
   if(chunkStart == -1){
-    test = FindStartCode(0);
+    test = FindStartCode(scanPos);
     if(test != -1)  //We found a new startcode
       chunkStart = test;
+    else
+      scanPos = std::max(scanPos, nextScanPos);
   }
-  if(chunkEnd == -1){
-    test = FindStartCode(chunkStart+4);
+  if(chunkStart != -1 && chunkEnd == -1){
+    uint32_t startPos = std::max<uint32_t>(chunkStart + 4, scanPos);
+    test = FindStartCode(startPos);
     if(test != -1)  //We found a new startcode
       chunkEnd = test;
+    else
+      scanPos = std::max(startPos, nextScanPos);
   }
   if(chunkStart == -1 || chunkEnd == -1){
     state = MPEG2_BUFFER_STATE_NEED_MORE_DATA;
@@ -101,10 +110,11 @@ MPEGChunk * MPEGVideoBuffer::ReadChunk(){
       myBuffer->Skip(chunkStart);
     }
     uint32_t chunkLength = chunkEnd - chunkStart;
-    binary* chunkData = new binary[chunkLength];
+    binary* chunkData = (binary *)safemalloc(chunkLength);
     myBuffer->Read(chunkData, chunkLength);
     chunkStart = 0; //we read up to the next start code
     chunkEnd = -1;
+    scanPos = 0;
     UpdateState();
     myChunk = new MPEGChunk(chunkData, chunkLength);
     return myChunk;
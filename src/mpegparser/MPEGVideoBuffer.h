@@ -98,8 +98,15 @@ public:
   }
 
   ~MPEGChunk(){
-    if(data)
-      delete [] data;
+    safefree(data);
+  }
+
+  //Hands the data allocated with safemalloc() over to the caller.
+  binary * ReleaseData(){
+    binary *released = data;
+    data = nullptr;
+    size = 0;
+    return released;
   }
 
   inline uint8_t GetType() const {
@@ -133,6 +140,7 @@ private:
   MPEG2BufferState_e state;
   int32_t chunkStart;
   int32_t chunkEnd;
+  uint32_t scanPos;
   void UpdateState();
   int32_t FindStartCode(uint32_t startPos = 0);
 public:
@@ -141,6 +149,7 @@ public:
     state = MPEG2_BUFFER_STATE_EMPTY;
     chunkStart = -1;
     chunkEnd = -1;
+    scanPos = 0;
   }
 
   ~MPEGVideoBuffer(){
@@ -21,7 +21,6 @@
 class mpeg4_p10_video_packetizer_c: public video_packetizer_c {
 protected:
   int m_nalu_size_len_src, m_nalu_size_len_dst;
-  int64_t m_max_nalu_size;
 
 public:
   mpeg4_p10_video_packetizer_c(generic_reader_c *p_reader, track_info_c &p_ti, double fps, int width, int height);
@@ -37,8 +36,6 @@ public:
 protected:
   virtual void extract_aspect_ratio();
   virtual void setup_nalu_size_len_change();
-  virtual void change_nalu_size_len(packet_cptr packet);
-  virtual void remove_filler_nalus(memory_c &data) const;
 };
 
 #endif  // MTX_P_MPEG4_P10_H
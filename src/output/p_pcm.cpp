@@ -74,18 +74,50 @@ pcm_packetizer_c::process(packet_cptr packet) {
   if (packet->has_timecode() && (packet->data->get_size() >= m_min_packet_size))
     return process_packaged(packet);
 
-  m_buffer.add(packet->data->get_buffer(), packet->data->get_size());
+  // Data that already has the right size is passed on as it is.
+  if (!m_buffer.get_size() && (packet->data->get_size() == m_packet_size)) {
+    packet->data->grab();
+    add_packet_of_packet_size(packet->data);
 
-  while (m_buffer.get_size() >= m_packet_size) {
-    add_packet(new packet_t(memory_c::clone(m_buffer.get_buffer(), m_packet_size), m_samples_output * m_s2tc, m_samples_per_packet * m_s2tc));
+    return FILE_STATUS_MOREDATA;
+  }
+
+  auto data      = packet->data->get_buffer();
+  auto remaining = packet->data->get_size();
+
+  // Complete the packet started with data left over from the previous
+  // call first. Then create packets directly from the source data and
+  // only buffer what is left at the end.
+  if (m_buffer.get_size()) {
+    auto to_add = std::min(m_packet_size - m_buffer.get_size(), remaining);
+    m_buffer.add(data, to_add);
+    data      += to_add;
+    remaining -= to_add;
 
+    if (m_buffer.get_size() < m_packet_size)
+      return FILE_STATUS_MOREDATA;
+
+    add_packet_of_packet_size(memory_c::clone(m_buffer.get_buffer(), m_packet_size));
     m_buffer.remove(m_packet_size);
-    m_samples_output += m_samples_per_packet;
   }
 
+  while (remaining >= m_packet_size) {
+    add_packet_of_packet_size(memory_c::clone(data, m_packet_size));
+    data      += m_packet_size;
+    remaining -= m_packet_size;
+  }
+
+  m_buffer.add(data, remaining);
+
   return FILE_STATUS_MOREDATA;
 }
 
+void
+pcm_packetizer_c::add_packet_of_packet_size(memory_cptr const &data) {
+  add_packet(new packet_t(data, m_samples_output * m_s2tc, m_samples_per_packet * m_s2tc));
+  m_samples_output += m_samples_per_packet;
+}
+
 int
 pcm_packetizer_c::process_packaged(packet_cptr packet) {
   int64_t samples_here = m_buffer.get_size() * 8 / m_channels / m_bits_per_sample;
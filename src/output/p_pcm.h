@@ -50,6 +50,8 @@ public:
 protected:
   virtual int process_packaged(packet_cptr packet);
   virtual void flush_impl();
+
+  void add_packet_of_packet_size(memory_cptr const &data);
 };
 
 #endif // MTX_P_PCM_H
@@ -0,0 +1,895 @@
+/*
+   cluster_validator - A tool for validating Matroska clusters in parallel
+
+   Distributed under the GPL
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include <ebml/EbmlCrc32.h>
+#include <ebml/EbmlHead.h>
+#include <ebml/EbmlVoid.h>
+#include <matroska/KaxAttachments.h>
+#include <matroska/KaxBlock.h>
+#include <matroska/KaxChapters.h>
+#include <matroska/KaxCluster.h>
+#include <matroska/KaxClusterData.h>
+#include <matroska/KaxCues.h>
+#include <matroska/KaxInfo.h>
+#include <matroska/KaxSeekHead.h>
+#include <matroska/KaxSegment.h>
+#include <matroska/KaxTags.h>
+#include <matroska/KaxTrackEntryData.h>
+#include <matroska/KaxTracks.h>
+
+#include "common/checksums.h"
+#include "common/ebml.h"
+#include "common/endian.h"
+#include "common/fs_sys_helpers.h"
+#include "common/mm_io.h"
+#include "common/mm_read_buffer_io.h"
+#include "common/strings/parsing.h"
+#include "common/translation.h"
+#include "common/vint.h"
+
+using namespace libebml;
+using namespace libmatroska;
+
+// Element IDs taken from libebml/libmatroska. They're filled in once by
+// init_element_ids() before any worker thread is started; the libraries'
+// class information cannot be relied upon during static initialization.
+struct element_ids_t {
+  uint32_t ebml_head, segment, seek_head, info, tracks, track_entry, track_number, cluster, cues, attachments, chapters, tags, cluster_timecode, silent_tracks, position, prev_size, simple_block, block_group, block, encrypted_block, crc32, void_element;
+};
+
+static element_ids_t g_ids;
+
+struct issue_t {
+  int64_t m_position;
+  bool m_is_error;
+  std::string m_code, m_details;
+
+  issue_t(int64_t position,
+          bool is_error,
+          std::string const &code,
+          std::string const &details)
+    : m_position(position)
+    , m_is_error(is_error)
+    , m_code(code)
+    , m_details(details)
+  {
+  }
+};
+
+// A cluster is read by the main thread and validated by one of the
+// worker threads. Its data is freed as soon as it has been validated;
+// only the results are kept for the report.
+struct cluster_t {
+  int64_t m_position, m_data_position, m_size, m_previous_size;
+  memory_cptr m_data;
+
+  bool m_has_timecode;
+  uint64_t m_timecode;
+  size_t m_num_blocks;
+  int m_min_relative_timecode;
+  std::set<uint64_t> m_track_numbers;
+  std::vector<issue_t> m_issues;
+
+  cluster_t()
+    : m_position(0)
+    , m_data_position(0)
+    , m_size(0)
+    , m_previous_size(-1)
+    , m_has_timecode(false)
+    , m_timecode(0)
+    , m_num_blocks(0)
+    , m_min_relative_timecode(0)
+  {
+  }
+};
+typedef std::shared_ptr<cluster_t> cluster_cptr;
+
+static unsigned int g_num_jobs = 0;
+static bool g_check_crc        = true;
+static bool g_verbose          = false;
+
+static int64_t g_segment_data_start = 0;
+static uint32_t const *g_crc_table  = nullptr;
+
+static std::vector<cluster_cptr> g_clusters;
+static std::vector<issue_t> g_file_issues;
+static std::set<uint64_t> g_track_numbers;
+static bool g_tracks_found = false;
+
+static void
+show_help() {
+  mxinfo(Y("cluster_validator [options] input_file_name\n"
+           "\n"
+           "Validates the structure of all clusters, the block timecodes, the lacing\n"
+           "and the CRC-32 elements in clusters and block groups on all CPU cores.\n"
+           "\n"
+           "Options:\n"
+           "\n"
+           "  -j, --jobs <n>         Use n threads for validation (default: number of\n"
+           "                         CPU cores)\n"
+           "  -n, --no-crc           Do not verify CRC-32 elements\n"
+           "  -v, --verbose          Output one line for each cluster\n"
+           "\n"
+           "General options:\n"
+           "\n"
+           "  -h, --help             This help text\n"
+           "  -V, --version          Print version information\n"
+           "\n"
+           "Output: one line per entry with tab-separated fields:\n"
+           "\n"
+           "  error|warning <position> <code> [<details>]\n"
+           "  cluster <position> <size> <timecode> <number of blocks>\n"
+           "  summary <clusters> <blocks> <errors> <warnings> <bytes> <milliseconds>\n"
+           "\n"
+           "The exit code is 0 if no problems were found, 1 if only warnings were\n"
+           "issued and 2 if errors were found.\n"));
+  mxexit(0);
+}
+
+static void
+show_version() {
+  mxinfo("cluster_validator v" VERSION "\n");
+  mxexit(0);
+}
+
+static std::string
+parse_args(std::vector<std::string> &args) {
+  std::string file_name;
+
+  std::vector<std::string>::iterator arg = args.begin();
+  while (arg != args.end()) {
+    if ((*arg == "-h") || (*arg == "--help"))
+      show_help();
+
+    else if ((*arg == "-V") || (*arg == "--version"))
+      show_version();
+
+    else if ((*arg == "-j") || (*arg == "--jobs")) {
+      ++arg;
+      if ((args.end() == arg) || !parse_number(*arg, g_num_jobs) || (0 == g_num_jobs))
+        mxerror(Y("Missing/wrong argument to --jobs\n"));
+
+    } else if ((*arg == "-n") || (*arg == "--no-crc"))
+      g_check_crc = false;
+
+    else if ((*arg == "-v") || (*arg == "--verbose"))
+      g_verbose = true;
+
+    else if (!file_name.empty())
+      mxerror(Y("More than one input file given\n"));
+
+    else
+      file_name = *arg;
+
+    ++arg;
+  }
+
+  if (file_name.empty())
+    mxerror(Y("No file name given\n"));
+
+  if (0 == g_num_jobs)
+    g_num_jobs = std::max(1u, std::thread::hardware_concurrency());
+
+  return file_name;
+}
+
+static void
+init_element_ids() {
+  g_ids.ebml_head        = EBML_ID_VALUE(EBML_ID(EbmlHead));
+  g_ids.segment          = EBML_ID_VALUE(EBML_ID(KaxSegment));
+  g_ids.seek_head        = EBML_ID_VALUE(EBML_ID(KaxSeekHead));
+  g_ids.info             = EBML_ID_VALUE(EBML_ID(KaxInfo));
+  g_ids.tracks           = EBML_ID_VALUE(EBML_ID(KaxTracks));
+  g_ids.track_entry      = EBML_ID_VALUE(EBML_ID(KaxTrackEntry));
+  g_ids.track_number     = EBML_ID_VALUE(EBML_ID(KaxTrackNumber));
+  g_ids.cluster          = EBML_ID_VALUE(EBML_ID(KaxCluster));
+  g_ids.cues             = EBML_ID_VALUE(EBML_ID(KaxCues));
+  g_ids.attachments      = EBML_ID_VALUE(EBML_ID(KaxAttachments));
+  g_ids.chapters         = EBML_ID_VALUE(EBML_ID(KaxChapters));
+  g_ids.tags             = EBML_ID_VALUE(EBML_ID(KaxTags));
+  g_ids.cluster_timecode = EBML_ID_VALUE(EBML_ID(KaxClusterTimecode));
+  g_ids.silent_tracks    = EBML_ID_VALUE(EBML_ID(KaxClusterSilentTracks));
+  g_ids.position         = EBML_ID_VALUE(EBML_ID(KaxClusterPosition));
+  g_ids.prev_size        = EBML_ID_VALUE(EBML_ID(KaxClusterPrevSize));
+  g_ids.simple_block     = EBML_ID_VALUE(EBML_ID(KaxSimpleBlock));
+  g_ids.block_group      = EBML_ID_VALUE(EBML_ID(KaxBlockGroup));
+  g_ids.block            = EBML_ID_VALUE(EBML_ID(KaxBlock));
+  g_ids.encrypted_block  = EBML_ID_VALUE(EBML_ID(KaxEncryptedBlock));
+  g_ids.crc32            = EBML_ID_VALUE(EBML_ID(EbmlCrc32));
+  g_ids.void_element     = EBML_ID_VALUE(EBML_ID(EbmlVoid));
+}
+
+static bool
+is_level1_id(uint32_t id) {
+  return (g_ids.cluster     == id)
+      || (g_ids.cues        == id)
+      || (g_ids.seek_head   == id)
+      || (g_ids.info        == id)
+      || (g_ids.tracks      == id)
+      || (g_ids.attachments == id)
+      || (g_ids.chapters    == id)
+      || (g_ids.tags        == id)
+      || (g_ids.ebml_head   == id)
+      || (g_ids.segment     == id);
+}
+
+// Reads an EBML ID or size from memory. Returns an invalid vint_c if
+// it does not fit into the remaining bytes.
+static vint_c
+get_vint(unsigned char const *&ptr,
+         unsigned char const *end,
+         bool is_id) {
+  if (ptr >= end)
+    return vint_c();
+
+  int mask   = 0x80;
+  int length = 1;
+
+  while ((0 != mask) && (0 == (*ptr & mask))) {
+    mask >>= 1;
+    ++length;
+  }
+
+  if ((0 == mask) || (is_id && (4 < length)) || ((end - ptr) < length))
+    return vint_c();
+
+  int64_t value = is_id ? *ptr : *ptr & ~mask;
+  for (int idx = 1; idx < length; ++idx)
+    value = (value << 8) | ptr[idx];
+
+  ptr += length;
+
+  return vint_c(value, length);
+}
+
+static uint64_t
+get_uint(unsigned char const *ptr,
+         int64_t size) {
+  return 0 == size ? 0 : get_uint_be(ptr, size);
+}
+
+class cluster_checker_c {
+protected:
+  cluster_t &m_cluster;
+  unsigned char const *m_base;
+
+public:
+  cluster_checker_c(cluster_t &cluster)
+    : m_cluster(cluster)
+    , m_base(cluster.m_data ? cluster.m_data->get_buffer() : nullptr)
+  {
+  }
+
+  void check();
+
+protected:
+  void add_issue(bool is_error, unsigned char const *ptr, std::string const &code, std::string const &details = std::string{}) {
+    m_cluster.m_issues.emplace_back(m_cluster.m_data_position + (ptr - m_base), is_error, code, details);
+  }
+
+  void check_crc(unsigned char const *element, unsigned char const *crc, int64_t crc_size, unsigned char const *data, unsigned char const *end);
+  void check_block_group(unsigned char const *ptr, unsigned char const *end);
+  void check_block(unsigned char const *element, unsigned char const *ptr, unsigned char const *end);
+  void check_lacing(unsigned char const *element, int lacing, unsigned char const *ptr, unsigned char const *end);
+};
+
+void
+cluster_checker_c::check() {
+  auto ptr   = m_base;
+  auto end   = m_base + (m_cluster.m_data ? m_cluster.m_data->get_size() : 0);
+  auto first = true;
+
+  while (ptr < end) {
+    auto element = ptr;
+    auto id      = get_vint(ptr, end, true);
+    auto size    = id.is_valid() ? get_vint(ptr, end, false) : vint_c();
+
+    if (!id.is_valid() || !size.is_valid()) {
+      add_issue(true, element, "invalid_element_header");
+      break;
+    }
+
+    if (size.is_unknown() || (size.m_value > (end - ptr))) {
+      add_issue(true, element, "element_exceeds_parent", (boost::format("id=0x%|1$x| size=%2% available=%3%") % id.m_value % size.m_value % (end - ptr)).str());
+      break;
+    }
+
+    auto content  = ptr;
+    ptr          += size.m_value;
+
+    if ((g_ids.crc32 != id.m_value) && (8 < size.m_value) && (   (g_ids.cluster_timecode == id.m_value)
+                                                              || (g_ids.position         == id.m_value)
+                                                              || (g_ids.prev_size        == id.m_value))) {
+      add_issue(true, element, "invalid_integer_size", (boost::format("id=0x%|1$x| size=%2%") % id.m_value % size.m_value).str());
+      first = false;
+      continue;
+    }
+
+    if (g_ids.crc32 == id.m_value) {
+      if (!first)
+        add_issue(false, element, "crc_not_first_child");
+      else if (g_check_crc)
+        check_crc(element, content, size.m_value, ptr, end);
+
+    } else if (g_ids.cluster_timecode == id.m_value) {
+      if (m_cluster.m_has_timecode)
+        add_issue(true, element, "duplicate_timecode");
+
+      else {
+        m_cluster.m_has_timecode = true;
+        m_cluster.m_timecode     = get_uint(content, size.m_value);
+        if (0 != m_cluster.m_num_blocks)
+          add_issue(false, element, "timecode_after_blocks");
+      }
+
+    } else if (g_ids.position == id.m_value) {
+      auto position = get_uint(content, size.m_value);
+      if (position != static_cast<uint64_t>(m_cluster.m_position - g_segment_data_start))
+        add_issue(false, element, "position_mismatch", (boost::format("stored=%1% actual=%2%") % position % (m_cluster.m_position - g_segment_data_start)).str());
+
+    } else if (g_ids.prev_size == id.m_value) {
+      auto previous_size = get_uint(content, size.m_value);
+      if ((-1 != m_cluster.m_previous_size) && (previous_size != static_cast<uint64_t>(m_cluster.m_previous_size)))
+        add_issue(false, element, "prev_size_mismatch", (boost::format("stored=%1% actual=%2%") % previous_size % m_cluster.m_previous_size).str());
+
+    } else if (g_ids.simple_block == id.m_value)
+      check_block(element, content, ptr);
+
+    else if (g_ids.block_group == id.m_value)
+      check_block_group(content, ptr);
+
+    else if (g_ids.encrypted_block == id.m_value)
+      ++m_cluster.m_num_blocks;
+
+    else if ((g_ids.silent_tracks != id.m_value) && (g_ids.void_element != id.m_value))
+      add_issue(false, element, "unknown_element", (boost::format("id=0x%|1$x|") % id.m_value).str());
+
+    first = false;
+  }
+
+  if (!m_cluster.m_has_timecode)
+    m_cluster.m_issues.emplace_back(m_cluster.m_position, true, "missing_timecode", std::string{});
+
+  else if ((0 != m_cluster.m_num_blocks) && ((static_cast<int64_t>(m_cluster.m_timecode) + m_cluster.m_min_relative_timecode) < 0))
+    m_cluster.m_issues.emplace_back(m_cluster.m_position, true, "negative_block_timecode",
+                                    (boost::format("cluster=%1% relative=%2%") % m_cluster.m_timecode % m_cluster.m_min_relative_timecode).str());
+
+  m_cluster.m_data.reset();
+}
+
+void
+cluster_checker_c::check_crc(unsigned char const *element,
+                             unsigned char const *crc,
+                             int64_t crc_size,
+                             unsigned char const *data,
+                             unsigned char const *end) {
+  if (4 != crc_size) {
+    add_issue(true, element, "invalid_crc_size", (boost::format("size=%1%") % crc_size).str());
+    return;
+  }
+
+  uint32_t expected = get_uint32_le(crc);
+  uint32_t actual   = 0xffffffff ^ crc_calc(g_crc_table, 0xffffffff, data, end - data);
+
+  if (expected != actual)
+    add_issue(true, element, "crc_mismatch", (boost::format("stored=0x%|1$08x| actual=0x%|2$08x|") % expected % actual).str());
+}
+
+void
+cluster_checker_c::check_block_group(unsigned char const *ptr,
+                                     unsigned char const *end) {
+  auto group      = ptr;
+  auto num_blocks = 0u;
+  auto first      = true;
+
+  while (ptr < end) {
+    auto element = ptr;
+    auto id      = get_vint(ptr, end, true);
+    auto size    = id.is_valid() ? get_vint(ptr, end, false) : vint_c();
+
+    if (!id.is_valid() || !size.is_valid()) {
+      add_issue(true, element, "invalid_element_header");
+      return;
+    }
+
+    if (size.is_unknown() || (size.m_value > (end - ptr))) {
+      add_issue(true, element, "element_exceeds_parent", (boost::format("id=0x%|1$x| size=%2% available=%3%") % id.m_value % size.m_value % (end - ptr)).str());
+      return;
+    }
+
+    auto content  = ptr;
+    ptr          += size.m_value;
+
+    if (g_ids.block == id.m_value) {
+      ++num_blocks;
+      check_block(element, content, ptr);
+
+    } else if (g_ids.crc32 == id.m_value) {
+      if (!first)
+        add_issue(false, element, "crc_not_first_child");
+      else if (g_check_crc)
+        check_crc(element, content, size.m_value, ptr, end);
+    }
+
+    first = false;
+  }
+
+  if (1 != num_blocks)
+    add_issue(true, group, "invalid_number_of_blocks_in_group", (boost::format("blocks=%1%") % num_blocks).str());
+}
+
+void
+cluster_checker_c::check_block(unsigned char const *element,
+                               unsigned char const *ptr,
+                               unsigned char const *end) {
+  auto track_number = get_vint(ptr, end, false);
+
+  if (!track_number.is_valid() || ((end - ptr) < 3)) {
+    add_issue(true, element, "block_too_short");
+    return;
+  }
+
+  int relative_timecode = static_cast<int16_t>(get_uint16_be(ptr));
+  int lacing            = (ptr[2] >> 1) & 0x03;
+
+  if ((0 == m_cluster.m_num_blocks) || (relative_timecode < m_cluster.m_min_relative_timecode))
+    m_cluster.m_min_relative_timecode = relative_timecode;
+
+  ++m_cluster.m_num_blocks;
+  m_cluster.m_track_numbers.insert(track_number.m_value);
+
+  if (0 != lacing)
+    check_lacing(element, lacing, ptr + 3, end);
+}
+
+void
+cluster_checker_c::check_lacing(unsigned char const *element,
+                                int lacing,
+                                unsigned char const *ptr,
+                                unsigned char const *end) {
+  if (ptr >= end) {
+    add_issue(true, element, "lacing_invalid", "missing lace count");
+    return;
+  }
+
+  int num_frames        = *ptr + 1;
+  int64_t total_size    = 0;
+  int64_t previous_size = 0;
+  ++ptr;
+
+  // Fixed-size lacing: all frames have the same size.
+  if (2 == lacing) {
+    if (0 != ((end - ptr) % num_frames))
+      add_issue(true, element, "lacing_invalid", (boost::format("fixed: %1% bytes for %2% frames") % (end - ptr) % num_frames).str());
+    return;
+  }
+
+  // Xiph and EBML lacing: the sizes of all but the last frame are
+  // coded. The last frame takes up the remaining bytes.
+  for (int frame = 0; frame < (num_frames - 1); ++frame) {
+    int64_t frame_size = 0;
+
+    if (1 == lacing) {
+      do {
+        if (ptr >= end) {
+          add_issue(true, element, "lacing_invalid", "xiph: sizes exceed block");
+          return;
+        }
+        frame_size += *ptr;
+      } while (0xff == *ptr++);
+
+    } else {
+      auto coded_size = get_vint(ptr, end, false);
+      if (!coded_size.is_valid() || coded_size.is_unknown()) {
+        add_issue(true, element, "lacing_invalid", "ebml: invalid size");
+        return;
+      }
+
+      // All but the first size are signed differences to the
+      // previous frame's size.
+      frame_size = 0 == frame ? coded_size.m_value : previous_size + coded_size.m_value - ((1ll << (coded_size.m_coded_size * 7 - 1)) - 1);
+      if (0 > frame_size) {
+        add_issue(true, element, "lacing_invalid", (boost::format("ebml: negative size for frame %1%") % frame).str());
+        return;
+      }
+    }
+
+    previous_size  = frame_size;
+    total_size    += frame_size;
+  }
+
+  if (total_size > (end - ptr))
+    add_issue(true, element, "lacing_invalid", (boost::format("%1%: frame sizes %2% exceed remaining %3% bytes") % (1 == lacing ? "xiph" : "ebml") % total_size % (end - ptr)).str());
+}
+
+// The main thread reads the clusters sequentially and queues them. A
+// fixed number of worker threads validates them in parallel. Memory
+// usage is bounded by blocking the reader while the queued clusters
+// exceed a given size.
+class cluster_validator_pool_c {
+protected:
+  std::deque<cluster_cptr> m_queue;
+  size_t m_queued_bytes, m_max_queued_bytes;
+  bool m_finishing;
+
+  std::mutex m_mutex;
+  std::condition_variable m_entries_available, m_space_available;
+  std::vector<std::thread> m_threads;
+
+public:
+  cluster_validator_pool_c(unsigned int num_threads, size_t max_queued_bytes);
+  ~cluster_validator_pool_c();
+
+  void add(cluster_cptr const &cluster);
+  void finish();
+
+protected:
+  void run();
+};
+
+cluster_validator_pool_c::cluster_validator_pool_c(unsigned int num_threads,
+                                                   size_t max_queued_bytes)
+  : m_queued_bytes(0)
+  , m_max_queued_bytes(max_queued_bytes)
+  , m_finishing(false)
+{
+  for (auto idx = 0u; idx < num_threads; ++idx)
+    m_threads.emplace_back(&cluster_validator_pool_c::run, this);
+}
+
+cluster_validator_pool_c::~cluster_validator_pool_c() {
+  finish();
+}
+
+void
+cluster_validator_pool_c::add(cluster_cptr const &cluster) {
+  auto size = cluster->m_data ? cluster->m_data->get_size() : 0;
+
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    // Always accept a cluster if the queue is empty, even if it is
+    // larger than the limit all by itself.
+    m_space_available.wait(lock, [this, size]() { return m_queue.empty() || ((m_queued_bytes + size) <= m_max_queued_bytes); });
+
+    m_queue.push_back(cluster);
+    m_queued_bytes += size;
+  }
+
+  m_entries_available.notify_one();
+}
+
+void
+cluster_validator_pool_c::finish() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_finishing = true;
+  }
+
+  m_entries_available.notify_all();
+
+  for (auto &thread : m_threads)
+    if (thread.joinable())
+      thread.join();
+}
+
+void
+cluster_validator_pool_c::run() {
+  while (true) {
+    cluster_cptr cluster;
+
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_entries_available.wait(lock, [this]() { return m_finishing || !m_queue.empty(); });
+
+      if (m_queue.empty())
+        return;
+
+      cluster = m_queue.front();
+      m_queue.pop_front();
+    }
+
+    auto size = cluster->m_data ? cluster->m_data->get_size() : 0;
+
+    cluster_checker_c(*cluster).check();
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_queued_bytes -= std::min(m_queued_bytes, size);
+    }
+
+    m_space_available.notify_one();
+  }
+}
+
+static void
+add_file_issue(bool is_error,
+               int64_t position,
+               std::string const &code,
+               std::string const &details = std::string{}) {
+  g_file_issues.emplace_back(position, is_error, code, details);
+}
+
+// Searches for the next cluster ID byte by byte. Used for re-syncing
+// after an invalid level 1 element.
+static int64_t
+find_next_cluster(mm_io_c &in,
+                  int64_t pos,
+                  int64_t end) {
+  static unsigned char const s_cluster_id[4] = { 0x1f, 0x43, 0xb6, 0x75 };
+
+  auto buffer = memory_c::alloc(1 << 20);
+  auto base   = buffer->get_buffer();
+
+  while ((pos + 4) <= end) {
+    in.setFilePointer(pos);
+    int64_t num_read = in.read(base, std::min<int64_t>(buffer->get_size(), end - pos));
+    if (4 > num_read)
+      break;
+
+    auto ptr  = base;
+    auto last = base + num_read - 3;
+
+    while ((ptr = static_cast<unsigned char *>(memchr(ptr, s_cluster_id[0], last - ptr)))) {
+      if (!memcmp(ptr, s_cluster_id, 4))
+        return pos + (ptr - base);
+      ++ptr;
+    }
+
+    pos += num_read - 3;
+  }
+
+  return end;
+}
+
+// Clusters with an unknown size end where the next level 1 element
+// starts.
+static int64_t
+find_cluster_end(mm_io_c &in,
+                 int64_t pos,
+                 int64_t end) {
+  while (pos < end) {
+    in.setFilePointer(pos);
+
+    auto id = vint_c::read_ebml_id(&in);
+    if (!id.is_valid() || is_level1_id(id.m_value))
+      break;
+
+    auto size = vint_c::read(&in);
+    if (!size.is_valid() || size.is_unknown())
+      break;
+
+    pos = in.getFilePointer() + size.m_value;
+  }
+
+  return pos;
+}
+
+static void
+read_track_numbers(memory_cptr const &tracks) {
+  auto ptr = static_cast<unsigned char const *>(tracks->get_buffer());
+  auto end = ptr + tracks->get_size();
+
+  g_tracks_found = true;
+
+  while (ptr < end) {
+    auto id   = get_vint(ptr, end, true);
+    auto size = id.is_valid() ? get_vint(ptr, end, false) : vint_c();
+    if (!size.is_valid() || size.is_unknown() || (size.m_value > (end - ptr)))
+      return;
+
+    auto entry_end  = ptr + size.m_value;
+    ptr            += g_ids.track_entry == id.m_value ? 0 : size.m_value;
+
+    while (ptr < entry_end) {
+      auto child_id   = get_vint(ptr, entry_end, true);
+      auto child_size = child_id.is_valid() ? get_vint(ptr, entry_end, false) : vint_c();
+      if (!child_size.is_valid() || child_size.is_unknown() || (child_size.m_value > (entry_end - ptr)))
+        return;
+
+      if ((g_ids.track_number == child_id.m_value) && (8 >= child_size.m_value))
+        g_track_numbers.insert(get_uint(ptr, child_size.m_value));
+
+      ptr += child_size.m_value;
+    }
+  }
+}
+
+static memory_cptr
+read_element_data(mm_io_c &in,
+                  int64_t size) {
+  if (0 == size)
+    return memory_cptr{};
+
+  auto data = memory_c::alloc(size);
+  if (in.read(data->get_buffer(), size) != static_cast<uint64_t>(size))
+    throw mtx::mm_io::end_of_file_x();
+
+  return data;
+}
+
+static void
+scan_file(mm_io_c &in,
+          cluster_validator_pool_c &pool) {
+  int64_t file_size = in.get_size();
+
+  auto id   = vint_c::read_ebml_id(&in);
+  auto size = vint_c::read(&in);
+  if (!id.is_valid() || (g_ids.ebml_head != id.m_value) || !size.is_valid() || size.is_unknown())
+    mxerror(Y("The file is not a Matroska file.\n"));
+
+  in.setFilePointer(in.getFilePointer() + size.m_value);
+
+  int64_t segment_pos = in.getFilePointer();
+  id                  = vint_c::read_ebml_id(&in);
+  size                = vint_c::read(&in);
+  if (!id.is_valid() || (g_ids.segment != id.m_value) || !size.is_valid())
+    mxerror(Y("No segment found.\n"));
+
+  g_segment_data_start = in.getFilePointer();
+  int64_t segment_end  = size.is_unknown() ? file_size : g_segment_data_start + size.m_value;
+
+  if (segment_end > file_size) {
+    add_file_issue(true, segment_pos, "segment_truncated", (boost::format("size=%1% available=%2%") % size.m_value % (file_size - g_segment_data_start)).str());
+    segment_end = file_size;
+  }
+
+  int64_t pos                   = g_segment_data_start;
+  int64_t previous_cluster_size = -1;
+
+  while (pos < segment_end) {
+    in.setFilePointer(pos);
+
+    id   = vint_c::read_ebml_id(&in);
+    size = id.is_valid() ? vint_c::read(&in) : vint_c();
+
+    // Only the known level 1 elements, EBML Void and CRC-32 elements
+    // are allowed here. Anything else means that the previous element's
+    // size was wrong or that the file is damaged.
+    bool is_valid = id.is_valid() && size.is_valid() && (is_level1_id(id.m_value) || (g_ids.void_element == id.m_value) || (g_ids.crc32 == id.m_value));
+
+    if (!is_valid || (size.is_unknown() && (g_ids.cluster != id.m_value))) {
+      auto next_pos = find_next_cluster(in, pos + 1, segment_end);
+      add_file_issue(true, pos, "invalid_level1_element", (boost::format("skipped=%1%") % (next_pos - pos)).str());
+
+      pos                   = next_pos;
+      previous_cluster_size = -1;
+      continue;
+    }
+
+    int64_t data_pos = in.getFilePointer();
+    int64_t end_pos  = size.is_unknown() ? find_cluster_end(in, data_pos, segment_end) : data_pos + size.m_value;
+
+    if (end_pos > segment_end) {
+      add_file_issue(true, pos, "element_truncated", (boost::format("id=0x%|1$x| size=%2% available=%3%") % id.m_value % (end_pos - data_pos) % (segment_end - data_pos)).str());
+      end_pos = segment_end;
+    }
+
+    if (g_ids.cluster == id.m_value) {
+      auto cluster               = std::make_shared<cluster_t>();
+      cluster->m_position        = pos;
+      cluster->m_data_position   = data_pos;
+      cluster->m_size            = end_pos - pos;
+      cluster->m_previous_size   = previous_cluster_size;
+
+      in.setFilePointer(data_pos);
+      cluster->m_data = read_element_data(in, end_pos - data_pos);
+
+      g_clusters.push_back(cluster);
+      pool.add(cluster);
+
+      previous_cluster_size = cluster->m_size;
+
+    } else if ((g_ids.tracks == id.m_value) && (end_pos > data_pos)) {
+      in.setFilePointer(data_pos);
+      read_track_numbers(read_element_data(in, end_pos - data_pos));
+    }
+
+    pos = end_pos;
+  }
+}
+
+static int
+report(int64_t num_bytes,
+       int64_t elapsed_ms) {
+  std::vector<issue_t> issues(g_file_issues);
+  size_t num_blocks   = 0;
+  cluster_t *previous = nullptr;
+
+  for (auto &cluster : g_clusters) {
+    num_blocks += cluster->m_num_blocks;
+    issues.insert(issues.end(), cluster->m_issues.begin(), cluster->m_issues.end());
+
+    if (g_tracks_found)
+      for (auto track_number : cluster->m_track_numbers)
+        if (!g_track_numbers.count(track_number))
+          issues.emplace_back(cluster->m_position, true, "unknown_track", (boost::format("track=%1%") % track_number).str());
+
+    if (previous && cluster->m_has_timecode && (cluster->m_timecode < previous->m_timecode))
+      issues.emplace_back(cluster->m_position, false, "cluster_timecode_decreasing", (boost::format("previous=%1% current=%2%") % previous->m_timecode % cluster->m_timecode).str());
+
+    if (cluster->m_has_timecode)
+      previous = cluster.get();
+  }
+
+  if (!g_tracks_found)
+    issues.emplace_back(g_segment_data_start, false, "no_tracks", std::string{});
+
+  std::stable_sort(issues.begin(), issues.end(), [](issue_t const &a, issue_t const &b) { return a.m_position < b.m_position; });
+
+  // Issues and cluster lines are output in file order.
+  auto issue          = issues.begin();
+  size_t num_errors   = 0;
+  auto output_issues  = [&issues, &issue, &num_errors](int64_t up_to) {
+    for (; (issues.end() != issue) && (issue->m_position < up_to); ++issue) {
+      mxinfo(boost::format("%1%\t%2%\t%3%%4%%5%\n") % (issue->m_is_error ? "error" : "warning") % issue->m_position % issue->m_code % (issue->m_details.empty() ? "" : "\t") % issue->m_details);
+      if (issue->m_is_error)
+        ++num_errors;
+    }
+  };
+
+  for (auto &cluster : g_clusters) {
+    output_issues(cluster->m_position);
+    if (g_verbose)
+      mxinfo(boost::format("cluster\t%1%\t%2%\t%3%\t%4%\n") % cluster->m_position % cluster->m_size % cluster->m_timecode % cluster->m_num_blocks);
+  }
+
+  output_issues(std::numeric_limits<int64_t>::max());
+
+  mxinfo(boost::format("summary\t%1%\t%2%\t%3%\t%4%\t%5%\t%6%\n") % g_clusters.size() % num_blocks % num_errors % (issues.size() - num_errors) % num_bytes % elapsed_ms);
+
+  return 0 != num_errors ? 2 : !issues.empty() ? 1 : 0;
+}
+
+int
+main(int argc,
+     char **argv) {
+  mtx_common_init("cluster_validator", argv[0]);
+
+  std::vector<std::string> args = command_line_utf8(argc, argv);
+  std::string file_name         = parse_args(args);
+
+  // The table is initialized lazily; do that before the workers
+  // start using it.
+  g_crc_table = crc_get_table(CRC_32_IEEE_LE);
+  init_element_ids();
+
+  auto start_time = get_current_time_millis();
+  int64_t num_bytes = 0;
+
+  {
+    cluster_validator_pool_c pool(g_num_jobs, static_cast<size_t>(g_num_jobs) * 32 * 1024 * 1024);
+
+    try {
+      mm_read_buffer_io_c in(new mm_file_io_c(file_name), 1 << 20);
+      num_bytes = in.get_size();
+
+      try {
+        scan_file(in, pool);
+      } catch (mtx::mm_io::exception &ex) {
+        add_file_issue(true, in.getFilePointer(), "read_error", ex.what());
+      }
+
+    } catch (mtx::mm_io::exception &) {
+      mxerror(boost::format(Y("The file '%1%' could not be opened for reading.\n")) % file_name);
+    }
+
+    pool.finish();
+  }
+
+  mxexit(report(num_bytes, get_current_time_millis() - start_time));
+}
@@ -0,0 +1,19 @@
+#!/usr/bin/ruby -w
+
+# T_428max_memory_identical_output
+describe "mkvmerge / --max-memory must not change the output"
+
+[ "data/mkv/complex.mkv",
+  "data/ts/pts_outlier.ts",
+  "data/opus/v-opus.ogg -A data/avi/v.avi",
+].each do |args|
+  test args do
+    unlimited = tmp_name
+    limited   = tmp_name
+
+    merge args,                       :output => unlimited
+    merge "--max-memory 64K #{args}", :output => limited
+
+    hash_file(unlimited) == hash_file(limited) ? :ok : :bad
+  end
+end
@@ -0,0 +1,45 @@
+#include "common/common_pch.h"
+
+#include "common/bit_cursor.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+unsigned char const s_nalu[] = { 0x68, 0x00, 0x00, 0x03, 0x01, 0xff, 0x00, 0x00, 0x03, 0x00, 0x00, 0x03, 0x03, 0x80 };
+unsigned char const s_rbsp[] = { 0x68, 0x00, 0x00,       0x01, 0xff, 0x00, 0x00,       0x00, 0x00,       0x03, 0x80 };
+
+TEST(NaluBitReader, SkipsEmulationPreventionBytes) {
+  nalu_bit_reader_c r{s_nalu, sizeof(s_nalu)};
+
+  for (auto byte : s_rbsp)
+    EXPECT_EQ(byte, r.get_bits(8));
+
+  EXPECT_THROW(r.get_bits(1), mtx::mm_io::end_of_file_x);
+}
+
+TEST(NaluBitReader, SameBitsAsRbspReader) {
+  for (auto chunk = 1u; chunk <= 32; ++chunk) {
+    nalu_bit_reader_c n{s_nalu, sizeof(s_nalu)};
+    bit_reader_c r{s_rbsp, sizeof(s_rbsp)};
+
+    for (auto remaining = sizeof(s_rbsp) * 8; remaining >= chunk; remaining -= chunk) {
+      EXPECT_EQ(r.get_bit_position(), n.get_bit_position());
+      EXPECT_EQ(r.peek_bits(chunk),   n.peek_bits(chunk));
+      EXPECT_EQ(r.get_bits(chunk),    n.get_bits(chunk));
+    }
+  }
+}
+
+TEST(NaluBitReader, BitPositionsReferToRbsp) {
+  nalu_bit_reader_c r{s_nalu, sizeof(s_nalu)};
+
+  r.skip_bits(9 * 8);
+  EXPECT_EQ(9 * 8, r.get_bit_position());
+  EXPECT_EQ(0x03u, r.get_bits(8));
+
+  r.set_bit_position(3 * 8);
+  EXPECT_EQ(0x01u, r.get_bits(8));
+}
+
+}
@@ -0,0 +1,149 @@
+#include "common/common_pch.h"
+
+#include <matroska/KaxSegment.h>
+
+#include "common/ebml.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+using namespace libebml;
+using namespace libmatroska;
+
+// The recursive searches the lookup tables replaced. The tables must
+// return exactly what these return.
+const EbmlCallbacks *
+recursive_find_callbacks(const EbmlCallbacks &base,
+                         const EbmlId &id) {
+  const EbmlSemanticContext &context = EBML_INFO_CONTEXT(base);
+  size_t i;
+
+  if (EBML_INFO_ID(base) == id)
+    return &base;
+
+  for (i = 0; i < EBML_CTX_SIZE(context); i++)
+    if (id == EBML_CTX_IDX_ID(context,i))
+      return &EBML_CTX_IDX_INFO(context, i);
+
+  for (i = 0; i < EBML_CTX_SIZE(context); i++) {
+    if (!(context != EBML_SEM_CONTEXT(EBML_CTX_IDX(context,i))))
+      continue;
+    auto result = recursive_find_callbacks(EBML_CTX_IDX_INFO(context, i), id);
+    if (result)
+      return result;
+  }
+
+  return nullptr;
+}
+
+const EbmlCallbacks *
+recursive_find_callbacks(const EbmlCallbacks &base,
+                         const char *debug_name) {
+  const EbmlSemanticContext &context = EBML_INFO_CONTEXT(base);
+  size_t i;
+
+  if (!strcmp(debug_name, EBML_INFO_NAME(base)))
+    return &base;
+
+  for (i = 0; i < EBML_CTX_SIZE(context); i++)
+    if (!strcmp(debug_name, EBML_INFO_NAME(EBML_CTX_IDX_INFO(context, i))))
+      return &EBML_CTX_IDX_INFO(context, i);
+
+  for (i = 0; i < EBML_CTX_SIZE(context); i++) {
+    if (!(context != EBML_SEM_CONTEXT(EBML_CTX_IDX(context,i))))
+      continue;
+    auto result = recursive_find_callbacks(EBML_CTX_IDX_INFO(context, i), debug_name);
+    if (result)
+      return result;
+  }
+
+  return nullptr;
+}
+
+const EbmlCallbacks *
+recursive_find_parent_callbacks(const EbmlCallbacks &base,
+                                const EbmlId &id) {
+  const EbmlSemanticContext &context = EBML_INFO_CONTEXT(base);
+  size_t i;
+
+  for (i = 0; i < EBML_CTX_SIZE(context); i++)
+    if (id == EBML_CTX_IDX_ID(context,i))
+      return &base;
+
+  for (i = 0; i < EBML_CTX_SIZE(context); i++) {
+    if (!(context != EBML_SEM_CONTEXT(EBML_CTX_IDX(context,i))))
+      continue;
+    auto result = recursive_find_parent_callbacks(EBML_CTX_IDX_INFO(context, i), id);
+    if (result)
+      return result;
+  }
+
+  return nullptr;
+}
+
+const EbmlSemantic *
+recursive_find_semantic(const EbmlCallbacks &base,
+                        const EbmlId &id) {
+  const EbmlSemanticContext &context = EBML_INFO_CONTEXT(base);
+  size_t i;
+
+  for (i = 0; i < EBML_CTX_SIZE(context); i++)
+    if (id == EBML_CTX_IDX_ID(context,i))
+      return &EBML_CTX_IDX(context,i);
+
+  for (i = 0; i < EBML_CTX_SIZE(context); i++) {
+    if (!(context != EBML_SEM_CONTEXT(EBML_CTX_IDX(context,i))))
+      continue;
+    auto result = recursive_find_semantic(EBML_CTX_IDX_INFO(context, i), id);
+    if (result)
+      return result;
+  }
+
+  return nullptr;
+}
+
+void
+collect_callbacks(const EbmlCallbacks &base,
+                  std::vector<const EbmlCallbacks *> &all_callbacks) {
+  const EbmlSemanticContext &context = EBML_INFO_CONTEXT(base);
+  size_t i;
+
+  for (i = 0; i < EBML_CTX_SIZE(context); i++) {
+    auto &callbacks = EBML_CTX_IDX_INFO(context, i);
+    if (brng::find(all_callbacks, &callbacks) != all_callbacks.end())
+      continue;
+
+    all_callbacks.push_back(&callbacks);
+    collect_callbacks(callbacks, all_callbacks);
+  }
+}
+
+TEST(EbmlLookup, SameResultsAsRecursiveSearch) {
+  std::vector<const EbmlCallbacks *> all_callbacks{ &EBML_INFO(KaxSegment) };
+  collect_callbacks(EBML_INFO(KaxSegment), all_callbacks);
+
+  ASSERT_LT(100u, all_callbacks.size());
+
+  for (auto base : all_callbacks)
+    for (auto callbacks : all_callbacks) {
+      auto &id = EBML_INFO_ID(*callbacks);
+
+      EXPECT_EQ(recursive_find_callbacks(*base, id),                         find_ebml_callbacks(*base, id));
+      EXPECT_EQ(recursive_find_callbacks(*base, EBML_INFO_NAME(*callbacks)), find_ebml_callbacks(*base, EBML_INFO_NAME(*callbacks)));
+      EXPECT_EQ(recursive_find_parent_callbacks(*base, id),                  find_ebml_parent_callbacks(*base, id));
+      EXPECT_EQ(recursive_find_semantic(*base, id),                          find_ebml_semantic(*base, id));
+    }
+}
+
+TEST(EbmlLookup, UnknownElements) {
+  auto unknown_id = EbmlId(static_cast<uint32>(0x7fff), 2);
+
+  EXPECT_EQ(nullptr, find_ebml_callbacks(EBML_INFO(KaxSegment), unknown_id));
+  EXPECT_EQ(nullptr, find_ebml_callbacks(EBML_INFO(KaxSegment), "NoSuchElement"));
+  EXPECT_EQ(nullptr, find_ebml_parent_callbacks(EBML_INFO(KaxSegment), unknown_id));
+  EXPECT_EQ(nullptr, find_ebml_semantic(EBML_INFO(KaxSegment), unknown_id));
+  EXPECT_EQ(nullptr, create_ebml_element(EBML_INFO(KaxSegment), unknown_id));
+}
+
+}
@@ -0,0 +1,145 @@
+#include "common/common_pch.h"
+
+#if defined(HAVE_FLAC_FORMAT_H)
+
+#include "common/checksums.h"
+#include "common/flac.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+// Fixed block size of 4096 samples, 44.1 kHz, two channels, 16 bits.
+std::string
+header(unsigned int frame_number) {
+  auto result = std::string{"\xff\xf8\xc9\x18", 4} + static_cast<char>(frame_number & 0x7f);
+  auto crc    = crc_calc(crc_get_table(CRC_8_ATM), 0, reinterpret_cast<unsigned char const *>(result.c_str()), result.size());
+
+  return result + static_cast<char>(crc & 0xff);
+}
+
+std::string
+frame(unsigned int frame_number,
+      std::string const &payload) {
+  auto result = header(frame_number) + payload;
+  auto crc    = crc_calc(crc_get_table(CRC_16_ANSI), 0, reinterpret_cast<unsigned char const *>(result.c_str()), result.size());
+
+  return result + static_cast<char>(crc & 0xff) + static_cast<char>((crc >> 8) & 0xff);
+}
+
+std::string
+payload(size_t size,
+        unsigned int seed) {
+  auto result = std::string{};
+  for (auto idx = 0u; idx < size; ++idx)
+    result += static_cast<char>((idx * 7 + seed) & 0x7f);
+
+  return result;
+}
+
+size_t
+find_frame_size(std::string const &data,
+                size_t max_frame_size,
+                bool end_of_data,
+                flac_frame_search_t &search) {
+  return flac_find_frame_size(reinterpret_cast<unsigned char const *>(data.c_str()), data.size(), max_frame_size, end_of_data, search);
+}
+
+TEST(Flac, FrameHeaderSize) {
+  auto h = header(1);
+  auto b = reinterpret_cast<unsigned char const *>(h.c_str());
+
+  EXPECT_EQ(6u, flac_get_frame_header_size(b, h.size()));
+  EXPECT_EQ(0u, flac_get_frame_header_size(b, h.size() - 1));
+
+  auto broken_crc = h;
+  broken_crc[5]  ^= 0x01;
+  EXPECT_EQ(0u, flac_get_frame_header_size(reinterpret_cast<unsigned char const *>(broken_crc.c_str()), broken_crc.size()));
+
+  auto reserved_block_size = h;
+  reserved_block_size[2]   = 0x09;
+  EXPECT_EQ(0u, flac_get_frame_header_size(reinterpret_cast<unsigned char const *>(reserved_block_size.c_str()), reserved_block_size.size()));
+
+  auto no_sync_code = h;
+  no_sync_code[1]   = 0xf0;
+  EXPECT_EQ(0u, flac_get_frame_header_size(reinterpret_cast<unsigned char const *>(no_sync_code.c_str()), no_sync_code.size()));
+}
+
+TEST(Flac, FrameCrc) {
+  auto f = frame(1, payload(100, 1));
+
+  EXPECT_TRUE(flac_frame_crc_ok(reinterpret_cast<unsigned char const *>(f.c_str()), f.size()));
+
+  f[50] ^= 0x01;
+  EXPECT_FALSE(flac_frame_crc_ok(reinterpret_cast<unsigned char const *>(f.c_str()), f.size()));
+}
+
+TEST(Flac, FindFrameSize) {
+  auto f0   = frame(0, payload(100, 0));
+  auto data = f0 + frame(1, payload(120, 1)) + frame(2, payload(80, 2));
+
+  flac_frame_search_t search;
+  EXPECT_EQ(f0.size(), find_frame_size(data, 1000, false, search));
+  EXPECT_FALSE(search.crc_mismatch);
+}
+
+TEST(Flac, FindFrameSizeSyncCodeInPayload) {
+  auto f0   = frame(0, payload(50, 0) + header(7) + payload(50, 3));
+  auto data = f0 + frame(1, payload(120, 1)) + frame(2, payload(80, 2));
+
+  flac_frame_search_t search;
+  EXPECT_EQ(f0.size(), find_frame_size(data, 1000, false, search));
+  EXPECT_FALSE(search.crc_mismatch);
+}
+
+TEST(Flac, FindFrameSizeNeedsMoreData) {
+  auto f0   = frame(0, payload(100, 0));
+  auto data = f0 + frame(1, payload(120, 1));
+
+  flac_frame_search_t search;
+  EXPECT_EQ(0u, find_frame_size(data.substr(0, 60), 1000, false, search));
+  EXPECT_EQ(0u, find_frame_size(data.substr(0, f0.size() + 3), 1000, false, search));
+  EXPECT_EQ(f0.size(), find_frame_size(data, 1000, false, search));
+}
+
+TEST(Flac, FindFrameSizeDamagedFrame) {
+  auto f0 = frame(0, payload(100, 0));
+  f0[50] ^= 0x01;
+
+  auto data = f0;
+  for (auto idx = 1u; idx < 100; ++idx)
+    data += frame(idx, payload(100 + idx, idx));
+
+  // The search must end once it passes the maximum frame size instead
+  // of looking at the rest of the data.
+  flac_frame_search_t search;
+  EXPECT_EQ(f0.size(), find_frame_size(data, 2 * f0.size(), false, search));
+  EXPECT_TRUE(search.crc_mismatch);
+  EXPECT_GT(4 * f0.size(), search.position);
+}
+
+TEST(Flac, FindFrameSizeDamagedFrameAtEnd) {
+  auto f0 = frame(0, payload(100, 0));
+  f0[50] ^= 0x01;
+
+  auto f1 = frame(1, payload(120, 1));
+
+  flac_frame_search_t search;
+  EXPECT_EQ(f0.size(), find_frame_size(f0 + f1, 1000, true, search));
+  EXPECT_TRUE(search.crc_mismatch);
+}
+
+TEST(Flac, FindFrameSizeLastFrame) {
+  auto f0 = frame(0, payload(100, 0));
+
+  flac_frame_search_t search;
+  EXPECT_EQ(f0.size(), find_frame_size(f0 + "TAG" + payload(125, 5), 1000, true, search));
+  EXPECT_FALSE(search.crc_mismatch);
+
+  flac_frame_search_t truncated_search;
+  EXPECT_EQ(50u, find_frame_size(f0.substr(0, 50), 1000, true, truncated_search));
+}
+
+}
+
+#endif  // HAVE_FLAC_FORMAT_H
@@ -3,7 +3,9 @@
 #include "gtest/gtest.h"
 #include "tests/unit/util.h"
 
+#include "common/fs_sys_helpers.h"
 #include "common/mm_io_x.h"
+#include "common/mm_write_buffer_io.h"
 
 namespace {
 
@@ -16,4 +18,95 @@ TEST(MmIo, Slurp) {
   ASSERT_THROW(mm_file_io_c::slurp("doesnotexist"), mtx::mm_io::exception);
 }
 
+std::vector<std::string>
+getline_all(std::string const &content) {
+  std::vector<std::string> lines;
+  std::string line;
+  mm_text_io_c in{new mm_mem_io_c{reinterpret_cast<unsigned char const *>(content.c_str()), content.size()}};
+
+  while (in.getline2(line))
+    lines.push_back(line);
+
+  return lines;
+}
+
+std::vector<std::string>
+getlines_all(std::string const &content) {
+  mm_text_io_c in{new mm_mem_io_c{reinterpret_cast<unsigned char const *>(content.c_str()), content.size()}};
+  return in.getlines();
+}
+
+TEST(MmIo, TextGetlinesMatchesGetline) {
+  std::vector<std::string> contents{
+    "",
+    "single",
+    "unix\nlines\n\nend",
+    "unix\nlines\n",
+    "dos\r\nlines\r\n\r\nend\r\n",
+    "mac\rlines\r\rend",
+    "mixed\r\nlines\nand\rmore\n\r",
+    std::string{"nul\0bytes\ninside", 16},
+    "\xef\xbb\xbfwith BOM\n\xc3\xa4\xc3\xb6\xc3\xbc\r\n",
+    "\xef\xbb\xbfinvalid\nUTF\xff-8\nlost\n",
+    "\xef\xbb\xbftruncated\n\xe2\x82",
+  };
+
+  for (auto const &content : contents)
+    EXPECT_EQ(getline_all(content), getlines_all(content));
+}
+
+TEST(MmIo, TextGetlines) {
+  EXPECT_EQ(std::vector<std::string>({ "a", "", "b" }), getlines_all("a\r\n\r\nb\r\n"));
+  EXPECT_EQ(std::vector<std::string>({ "a", "b" }),     getlines_all("a\nb"));
+}
+
+TEST(MmIo, WriteGathered) {
+  mm_mem_io_c out{nullptr, 0, 100};
+
+  EXPECT_EQ(7u, out.write_gathered({ { "abc", 3 }, { "", 0 }, { "defg", 4 } }));
+  EXPECT_EQ(std::string{"abcdefg"}, out.get_content());
+}
+
+TEST(MmIo, FileWriteGatheredAfterRead) {
+  auto file_name = (bfs::temp_directory_path() / (boost::format("mtx-unit-test-%1%.bin") % get_current_time_millis()).str()).string();
+
+  {
+    mm_file_io_c file{file_name, MODE_CREATE};
+    file.write(std::string{"0123456789"});
+
+    // Reading makes stdio read ahead, leaving the descriptor's offset
+    // at the end of the file.
+    std::string read_back;
+    file.setFilePointer(0);
+    EXPECT_EQ(2u, file.read(read_back, 2));
+
+    EXPECT_EQ(3u, file.write_gathered({ { "ab", 2 }, { "c", 1 } }));
+    EXPECT_EQ(5u, file.getFilePointer());
+  }
+
+  EXPECT_EQ(std::string{"01abc56789"}, std::string{reinterpret_cast<char const *>(mm_file_io_c::slurp(file_name)->get_buffer()), 10});
+
+  boost::system::error_code ec;
+  bfs::remove(file_name, ec);
+}
+
+TEST(MmIo, WriteBufferMatchesDirectWrites) {
+  std::string content;
+  for (auto idx = 0; idx < 500; ++idx)
+    content += static_cast<char>(idx % 251);
+
+  auto mem_out = new mm_mem_io_c{nullptr, 0, 1000};
+  mm_write_buffer_io_c out{mem_out, 16};
+  size_t offset = 0;
+
+  for (auto size : std::vector<size_t>{ 1, 3, 16, 5, 40, 15, 1, 17, 100, 16, 32, 7, 0, 64, 33 }) {
+    ASSERT_EQ(size, out.write(content.c_str() + offset, size));
+    offset += size;
+    EXPECT_EQ(offset, out.getFilePointer());
+  }
+
+  out.flush();
+  EXPECT_EQ(content.substr(0, offset), mem_out->get_content());
+}
+
 }
@@ -0,0 +1,107 @@
+#include "common/common_pch.h"
+
+#include "common/mpeg.h"
+
+#include "gtest/gtest.h"
+#include "tests/unit/util.h"
+
+namespace {
+
+std::string
+nalu(unsigned int size_len,
+     std::string const &payload) {
+  std::string result;
+  for (auto shift = size_len; 0 < shift; --shift)
+    result += static_cast<char>((payload.size() >> (8 * (shift - 1))) & 0xff);
+
+  return result + payload;
+}
+
+memory_cptr
+frame(std::string const &content) {
+  return memory_c::clone(content);
+}
+
+std::string const s_slice{"\x65\x01\x02\x03", 4};
+std::string const s_filler{"\x0c\xff\xff\xff\xff\x80", 6};
+
+TEST(MpegRewriteNalus, RemovesFillersWithoutSizeChange) {
+  auto data = frame(nalu(4, s_slice) + nalu(4, s_filler) + nalu(4, s_filler) + nalu(4, s_slice) + nalu(4, s_filler));
+
+  ASSERT_TRUE(mtx::mpeg::rewrite_nalus(*data, 4, 4, 0x1f, 0x0c));
+  EXPECT_EQ(*data, nalu(4, s_slice) + nalu(4, s_slice));
+}
+
+TEST(MpegRewriteNalus, ShrinksSizeFields) {
+  auto data = frame(nalu(4, s_slice) + nalu(4, s_filler) + nalu(4, s_slice));
+
+  ASSERT_TRUE(mtx::mpeg::rewrite_nalus(*data, 4, 2, 0x1f, 0x0c));
+  EXPECT_EQ(*data, nalu(2, s_slice) + nalu(2, s_slice));
+}
+
+TEST(MpegRewriteNalus, GrowsSizeFields) {
+  auto data = frame(nalu(2, s_filler) + nalu(2, s_slice) + nalu(2, s_filler) + nalu(2, s_slice) + nalu(2, s_slice));
+
+  ASSERT_TRUE(mtx::mpeg::rewrite_nalus(*data, 2, 4, 0x1f, 0x0c));
+  EXPECT_EQ(*data, nalu(4, s_slice) + nalu(4, s_slice) + nalu(4, s_slice));
+}
+
+TEST(MpegRewriteNalus, KeepsTrailingBytesOnlyWithoutSizeChange) {
+  auto data = frame(nalu(4, s_slice) + std::string{"\x00\x01", 2});
+
+  ASSERT_TRUE(mtx::mpeg::rewrite_nalus(*data, 4, 4, 0x1f, 0x0c));
+  EXPECT_EQ(*data, nalu(4, s_slice) + std::string{"\x00\x01", 2});
+
+  data = frame(nalu(4, s_slice) + std::string{"\x00\x01", 2});
+
+  ASSERT_TRUE(mtx::mpeg::rewrite_nalus(*data, 4, 2, 0x1f, 0x0c));
+  EXPECT_EQ(*data, nalu(2, s_slice));
+}
+
+TEST(MpegRewriteNalus, TooBigForDestinationSizeLength) {
+  auto data = frame(nalu(4, std::string(300, '\x65')));
+
+  EXPECT_FALSE(mtx::mpeg::rewrite_nalus(*data, 4, 1, 0x1f, 0x0c));
+}
+
+TEST(MpegRewriteNalus, HevcFillers) {
+  std::string hevc_filler{"\x4c\x01\xff\xff\x80", 5};
+  std::string hevc_slice{"\x26\x01\xaf\x02", 4};
+  auto data = frame(nalu(4, hevc_slice) + nalu(4, hevc_filler) + nalu(4, hevc_slice));
+
+  ASSERT_TRUE(mtx::mpeg::rewrite_nalus(*data, 4, 4, 0x7e, 38 << 1));
+  EXPECT_EQ(*data, nalu(4, hevc_slice) + nalu(4, hevc_slice));
+}
+
+TEST(MpegSplitNalus, SameResultForAllBufferSplits) {
+  std::string stream{"\x17\x00\x00\x01\x67\x42\x00\x00\x00\x01\x68\xce\x00\x00\x01\x65\x88\x00\x01\x02\x00\x00\x00\x01\x41", 25};
+  std::vector<std::pair<std::string, size_t>> expected{
+    { std::string{"\x67\x42",                 2}, 1  },
+    { std::string{"\x68\xce",                 2}, 6  },
+    { std::string{"\x65\x88\x00\x01\x02",     5}, 12 },
+  };
+
+  for (auto split = 0u; split <= stream.size(); ++split) {
+    std::vector<std::pair<std::string, size_t>> found;
+    memory_cptr unparsed;
+    auto first  = memory_c::clone(stream.substr(0, split));
+    auto second = memory_c::clone(stream.substr(split));
+    auto store  = [&found](memory_cptr &nalu, size_t pos) {
+      found.emplace_back(std::string{reinterpret_cast<char *>(nalu->get_buffer()), nalu->get_size()}, pos);
+    };
+
+    auto offset       = mtx::mpeg::split_nalus(unparsed, first->get_buffer(), first->get_size(), store);
+    auto num_first    = found.size();
+    auto unparsed_pos = mtx::mpeg::split_nalus(unparsed, second->get_buffer(), second->get_size(), store);
+
+    for (auto idx = num_first; idx < found.size(); ++idx)
+      found[idx].second += offset;
+
+    EXPECT_EQ(expected, found) << "split at " << split;
+    EXPECT_EQ(20u, offset + unparsed_pos);
+    ASSERT_TRUE(!!unparsed);
+    EXPECT_EQ(std::string(stream, 20), std::string(reinterpret_cast<char *>(unparsed->get_buffer()), unparsed->get_size()));
+  }
+}
+
+}
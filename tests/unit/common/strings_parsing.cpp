@@ -0,0 +1,52 @@
+#include "common/common_pch.h"
+
+#include "common/strings/parsing.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+bool
+parse_range(std::string const &s,
+            double &value) {
+  return parse_number(s.c_str(), s.c_str() + s.length(), value);
+}
+
+TEST(StringsParsing, NumberRangeDecimal) {
+  double value;
+
+  EXPECT_TRUE(parse_range("0", value));                EXPECT_EQ(0.0,              value);
+  EXPECT_TRUE(parse_range("40", value));               EXPECT_EQ(40.0,             value);
+  EXPECT_TRUE(parse_range("41.708333", value));        EXPECT_EQ(41.708333,        value);
+  EXPECT_TRUE(parse_range("-12.5", value));            EXPECT_EQ(-12.5,            value);
+  EXPECT_TRUE(parse_range("0.1", value));              EXPECT_EQ(0.1,              value);
+  EXPECT_TRUE(parse_range("3600000.000000", value));   EXPECT_EQ(3600000.0,        value);
+  EXPECT_TRUE(parse_range("123456789.123456", value)); EXPECT_EQ(123456789.123456, value);
+}
+
+TEST(StringsParsing, NumberRangeSameAsStrtod) {
+  static char const *s_formats[] = { "%.0f", "%.1f", "%.3f", "%.6f", "%.9f" };
+
+  for (auto idx = 0; idx < 10000; ++idx) {
+    auto s = (boost::format(s_formats[idx % 5]) % (idx * 1234.56789012345)).str();
+    double value;
+
+    ASSERT_TRUE(parse_range(s, value));
+    EXPECT_EQ(std::strtod(s.c_str(), nullptr), value) << s;
+  }
+}
+
+TEST(StringsParsing, NumberRangeFallback) {
+  double value;
+
+  EXPECT_TRUE(parse_range("1e3", value));                    EXPECT_EQ(1000.0, value);
+  EXPECT_TRUE(parse_range("12345678901234567890.5", value)); EXPECT_EQ(12345678901234567890.5, value);
+
+  EXPECT_FALSE(parse_range("", value));
+  EXPECT_FALSE(parse_range("-", value));
+  EXPECT_FALSE(parse_range("1.2.3", value));
+  EXPECT_FALSE(parse_range("42 ", value));
+  EXPECT_FALSE(parse_range("abc", value));
+}
+
+}
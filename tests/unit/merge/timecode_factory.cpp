@@ -0,0 +1,125 @@
+#include "common/common_pch.h"
+
+#include "common/mm_io.h"
+#include "merge/timecode_factory.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+class v1_factory_c: public timecode_factory_v1_c {
+public:
+  v1_factory_c(std::string const &content)
+    : timecode_factory_v1_c{"dummy", "dummy", 0}
+  {
+    mm_text_io_c in(new mm_mem_io_c(reinterpret_cast<unsigned char const *>(content.c_str()), content.length()));
+    std::string line;
+    in.getline2(line);
+    parse(in);
+  }
+
+  using timecode_factory_v1_c::get_at;
+  using timecode_factory_v1_c::m_ranges;
+};
+
+class v2_factory_c: public timecode_factory_v2_c {
+public:
+  v2_factory_c(std::string const &content)
+    : timecode_factory_v2_c{"dummy", "dummy", 0, 2}
+  {
+    mm_text_io_c in(new mm_mem_io_c(reinterpret_cast<unsigned char const *>(content.c_str()), content.length()));
+    std::string line;
+    in.getline2(line);
+    parse(in);
+  }
+
+  using timecode_factory_v2_c::m_timecodes;
+  using timecode_factory_v2_c::m_durations;
+};
+
+// Ranges: 0-9 @ 25 (gap), 10-19 @ 50, 20-29 @ 25 (gap), 30-39 @ 12.5
+// and 40- @ 25 (after the last range).
+std::string const s_v1_file = "# timecode format v1\n"
+                              "assume 25\n"
+                              "30,39,12.5\n"
+                              "10,19,50\n";
+
+int64_t
+expected_timecode(uint64_t frame) {
+  return frame < 10 ?                               frame        * 40000000ll
+       : frame < 20 ?  400000000ll + (frame - 10) * 20000000ll
+       : frame < 30 ?  600000000ll + (frame - 20) * 40000000ll
+       : frame < 40 ? 1000000000ll + (frame - 30) * 80000000ll
+       :              1800000000ll + (frame - 40) * 40000000ll;
+}
+
+TEST(TimecodeFactoryV1, GapsFilledWithDefaultFps) {
+  v1_factory_c factory{s_v1_file};
+
+  ASSERT_EQ(5u, factory.m_ranges.size());
+
+  uint64_t const starts[] = {  0, 10, 20, 30, 40 };
+  uint64_t const ends[]   = {  9, 19, 29, 39, 0xfffffffffffffffull };
+  double const fps[]      = { 25, 50, 25, 12.5, 25 };
+
+  for (auto idx = 0u; idx < 5; ++idx) {
+    EXPECT_EQ(starts[idx],                     factory.m_ranges[idx].start_frame) << idx;
+    EXPECT_EQ(ends[idx],                       factory.m_ranges[idx].end_frame)   << idx;
+    EXPECT_EQ(fps[idx],                        factory.m_ranges[idx].fps)         << idx;
+    EXPECT_EQ(expected_timecode(starts[idx]), static_cast<int64_t>(factory.m_ranges[idx].base_timecode)) << idx;
+  }
+
+  for (auto frame = 0u; frame < 50; ++frame) {
+    auto packet = std::make_shared<packet_t>();
+    factory.get_next(packet);
+
+    EXPECT_EQ(expected_timecode(frame),                                packet->assigned_timecode) << frame;
+    EXPECT_EQ(expected_timecode(frame + 1) - expected_timecode(frame), packet->duration)          << frame;
+  }
+}
+
+TEST(TimecodeFactoryV1, AdjacentRangesWithoutGaps) {
+  v1_factory_c factory{"# timecode format v1\nassume 25\n0,4,50\n5,9,10\n"};
+
+  ASSERT_EQ(3u, factory.m_ranges.size());
+  EXPECT_EQ(0u,  factory.m_ranges[0].start_frame);
+  EXPECT_EQ(5u,  factory.m_ranges[1].start_frame);
+  EXPECT_EQ(10u, factory.m_ranges[2].start_frame);
+  EXPECT_EQ(25,  factory.m_ranges[2].fps);
+}
+
+TEST(TimecodeFactoryV1, GetAtOutsideCurrentRanges) {
+  v1_factory_c factory{s_v1_file};
+
+  // The current range is the first one; these frames lie further ahead.
+  EXPECT_EQ(expected_timecode(35),   factory.get_at(35));
+  EXPECT_EQ(expected_timecode(1000), factory.get_at(1000));
+  EXPECT_EQ(expected_timecode(25),   factory.get_at(25));
+
+  // Advance into the last range and look back.
+  for (auto frame = 0u; frame < 45; ++frame) {
+    auto packet = std::make_shared<packet_t>();
+    factory.get_next(packet);
+  }
+
+  for (auto frame : { 0u, 5u, 15u, 29u, 30u, 39u, 40u, 44u })
+    EXPECT_EQ(expected_timecode(frame), factory.get_at(frame)) << frame;
+}
+
+TEST(TimecodeFactoryV2, Parse) {
+  v2_factory_c factory{"# timecode format v2\n0\n# comment\n\n  40 \n80.5\n120.5"};
+
+  ASSERT_EQ(4u, factory.m_timecodes.size());
+  EXPECT_EQ(0,         factory.m_timecodes[0]);
+  EXPECT_EQ(40000000,  factory.m_timecodes[1]);
+  EXPECT_EQ(80500000,  factory.m_timecodes[2]);
+  EXPECT_EQ(120500000, factory.m_timecodes[3]);
+
+  ASSERT_EQ(4u, factory.m_durations.size());
+  EXPECT_EQ(40000000, factory.m_durations[0]);
+  EXPECT_EQ(40500000, factory.m_durations[1]);
+  EXPECT_EQ(40000000, factory.m_durations[2]);
+  EXPECT_EQ(40000000, factory.m_durations[3]);
+}
+
+}
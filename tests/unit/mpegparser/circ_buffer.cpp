@@ -0,0 +1,157 @@
+#include "common/common_pch.h"
+
+#include <random>
+
+#include "mpegparser/CircBuffer.h"
+#include "mpegparser/MPEGVideoBuffer.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+int32_t
+naive_find(CircBuffer &buffer,
+           binary value,
+           uint32_t start_pos,
+           uint32_t end_pos) {
+  end_pos = std::min(end_pos, buffer.GetLength());
+
+  for (auto pos = start_pos; pos < end_pos; ++pos)
+    if (buffer[pos] == value)
+      return pos;
+
+  return -1;
+}
+
+std::vector<binary>
+random_bytes(std::mt19937 &rng,
+             size_t size) {
+  // A small alphabet results in lots of matches, start codes and near
+  // misses.
+  static binary const s_alphabet[] = { 0x00, 0x00, 0x00, 0x01, 0x01, 0xb3, 0xb5, 0xb8, 0x42, 0xff };
+
+  auto bytes = std::vector<binary>(size);
+  for (auto &byte : bytes)
+    byte = s_alphabet[rng() % sizeof(s_alphabet)];
+
+  return bytes;
+}
+
+TEST(CircBuffer, FindMatchesNaiveSearch) {
+  std::mt19937 rng{42};
+
+  for (auto round = 0; round < 200; ++round) {
+    auto capacity = static_cast<uint32_t>(1 + rng() % 300);
+    CircBuffer buffer{capacity};
+
+    // Move the read and write pointers to a random position so that
+    // the data wraps around the end of the buffer.
+    auto offset = static_cast<uint32_t>(rng() % capacity);
+    if (offset) {
+      auto filler = random_bytes(rng, offset);
+      ASSERT_EQ(0, buffer.Write(filler.data(), offset));
+      ASSERT_EQ(0, buffer.Skip(offset));
+    }
+
+    auto size = static_cast<uint32_t>(rng() % (capacity + 1));
+    if (size) {
+      auto data = random_bytes(rng, size);
+      ASSERT_EQ(0, buffer.Write(data.data(), size));
+    }
+
+    for (auto search = 0; search < 50; ++search) {
+      auto value     = static_cast<binary>(rng() % 3);
+      auto start_pos = static_cast<uint32_t>(rng() % (size + 2));
+      auto end_pos   = static_cast<uint32_t>(rng() % (size + 4));
+
+      EXPECT_EQ(naive_find(buffer, value, start_pos, end_pos), buffer.Find(value, start_pos, end_pos))
+        << "capacity " << capacity << " offset " << offset << " size " << size << " value " << static_cast<unsigned int>(value) << " start " << start_pos << " end " << end_pos;
+    }
+  }
+}
+
+bool
+is_wanted_start_code(std::vector<binary> const &data,
+                     size_t pos) {
+  return ((pos + 4) <= data.size())
+      && (0x00 == data[pos])
+      && (0x00 == data[pos + 1])
+      && (0x01 == data[pos + 2])
+      && (   (MPEG_VIDEO_PICTURE_START_CODE  == data[pos + 3])
+          || (MPEG_VIDEO_SEQUENCE_START_CODE == data[pos + 3])
+          || (MPEG_VIDEO_GOP_START_CODE      == data[pos + 3]));
+}
+
+// A chunk starts at a wanted start code and ends at the next one
+// beginning at least four bytes later. The last chunk ends with the
+// data.
+std::vector<std::vector<binary>>
+naive_chunks(std::vector<binary> const &data) {
+  auto starts = std::vector<size_t>{};
+
+  for (size_t pos = 0; pos < data.size(); ++pos)
+    if (   is_wanted_start_code(data, pos)
+        && (starts.empty() || (pos >= (starts.back() + 4))))
+      starts.push_back(pos);
+
+  auto chunks = std::vector<std::vector<binary>>{};
+  for (size_t idx = 0; idx < starts.size(); ++idx) {
+    auto end = (idx + 1) < starts.size() ? starts[idx + 1] : data.size();
+    chunks.emplace_back(data.begin() + starts[idx], data.begin() + end);
+  }
+
+  return chunks;
+}
+
+std::vector<binary>
+random_stream(std::mt19937 &rng) {
+  static binary const s_codes[] = { MPEG_VIDEO_PICTURE_START_CODE, MPEG_VIDEO_SEQUENCE_START_CODE, MPEG_VIDEO_GOP_START_CODE };
+
+  auto stream = std::vector<binary>{};
+
+  // Explicit start codes at least every 1000 bytes keep chunks smaller
+  // than the buffer.
+  while (stream.size() < 100000) {
+    stream.insert(stream.end(), { 0x00, 0x00, 0x01, s_codes[rng() % 3] });
+
+    auto payload = random_bytes(rng, 4 + rng() % 1000);
+    stream.insert(stream.end(), payload.begin(), payload.end());
+  }
+
+  return stream;
+}
+
+TEST(MPEGVideoBuffer, ChunksMatchNaiveSplitting) {
+  std::mt19937 rng{4711};
+
+  for (auto round = 0; round < 20; ++round) {
+    auto stream = random_stream(rng);
+    auto chunks = std::vector<std::vector<binary>>{};
+    MPEGVideoBuffer buffer{64 * 1024};
+
+    auto read_chunks = [&buffer, &chunks]() {
+      while (MPEG2_BUFFER_STATE_CHUNK_READY == buffer.GetState()) {
+        auto chunk = std::unique_ptr<MPEGChunk>{buffer.ReadChunk()};
+        chunks.emplace_back(chunk->GetPointer(), chunk->GetPointer() + chunk->GetSize());
+      }
+    };
+
+    size_t pos = 0;
+    while (pos < stream.size()) {
+      auto to_feed = std::min<size_t>({ stream.size() - pos, 1 + rng() % 4096, static_cast<size_t>(buffer.GetFreeBufferSpace()) });
+      ASSERT_LT(0u, to_feed);
+
+      buffer.Feed(&stream[pos], to_feed);
+      pos += to_feed;
+
+      read_chunks();
+    }
+
+    buffer.ForceFinal();
+    read_chunks();
+
+    EXPECT_TRUE(naive_chunks(stream) == chunks) << "round " << round;
+  }
+}
+
+}